@@ -0,0 +1,122 @@
+// Replaces the global operator new/delete with versions that report each allocation to the allocation_tracker of
+// the parser phase running on the calling thread. This file is not part of the argument_parser library: link the
+// argument_parser::allocation_interposition object library into the executable to opt in, so the replacement is
+// defined exactly once.
+#include <instrumentation.hpp>
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+	// std::aligned_alloc wants a size that is a multiple of the alignment; MSVC has no aligned_alloc at all and its
+	// _aligned_malloc blocks must go back through _aligned_free
+	void *aligned_allocate(std::size_t size, std::align_val_t alignment) noexcept {
+		auto const align = static_cast<std::size_t>(alignment);
+		std::size_t const rounded = size == 0 ? align : (size + align - 1) / align * align;
+#ifdef _WIN32
+		return _aligned_malloc(rounded, align);
+#else
+		return std::aligned_alloc(align, rounded);
+#endif
+	}
+
+	void aligned_free(void *ptr) noexcept {
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif
+	}
+} // namespace
+
+void *operator new(std::size_t size) {
+	argument_parser::instrumentation::detail::record_allocation(size);
+	if (void *ptr = std::malloc(size == 0 ? 1 : size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+	return ::operator new(size);
+}
+
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept {
+	argument_parser::instrumentation::detail::record_allocation(size);
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t size, std::nothrow_t const &tag) noexcept {
+	return ::operator new(size, tag);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+	argument_parser::instrumentation::detail::record_allocation(size);
+	if (void *ptr = aligned_allocate(size, alignment))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+	return ::operator new(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept {
+	argument_parser::instrumentation::detail::record_allocation(size);
+	return aligned_allocate(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, std::nothrow_t const &tag) noexcept {
+	return ::operator new(size, alignment, tag);
+}
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::nothrow_t const &) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::nothrow_t const &) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, std::nothrow_t const &) noexcept {
+	aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, std::nothrow_t const &) noexcept {
+	aligned_free(ptr);
+}
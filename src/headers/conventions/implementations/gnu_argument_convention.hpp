@@ -21,7 +21,7 @@ namespace argument_parser::conventions::implementations {
 		static gnu_argument_convention instance;
 
 	private:
-		gnu_argument_convention() = default;
+		constexpr gnu_argument_convention() = default;
 	};
 
 	class gnu_equal_argument_convention : public base_convention {
@@ -39,17 +39,18 @@ namespace argument_parser::conventions::implementations {
 		static gnu_equal_argument_convention instance;
 
 	private:
-		gnu_equal_argument_convention() = default;
+		constexpr gnu_equal_argument_convention() = default;
 	};
 
 	inline gnu_argument_convention gnu_argument_convention::instance{};
 	inline gnu_equal_argument_convention gnu_equal_argument_convention::instance{};
 } // namespace argument_parser::conventions::implementations
 
+// references rather than per-TU copies: the instances above are constant-initialized, so nothing runs at startup
 namespace argument_parser::conventions {
-	static const implementations::gnu_argument_convention gnu_argument_convention =
+	inline constexpr implementations::gnu_argument_convention const &gnu_argument_convention =
 		implementations::gnu_argument_convention::instance;
-	static const implementations::gnu_equal_argument_convention gnu_equal_argument_convention =
+	inline constexpr implementations::gnu_equal_argument_convention const &gnu_equal_argument_convention =
 		implementations::gnu_equal_argument_convention::instance;
 } // namespace argument_parser::conventions
 
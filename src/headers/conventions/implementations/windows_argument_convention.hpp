@@ -11,7 +11,7 @@
 namespace argument_parser::conventions::implementations {
 	class windows_argument_convention : public base_convention {
 	public:
-		explicit windows_argument_convention(bool accept_dash = true);
+		constexpr explicit windows_argument_convention(bool accept_dash = true) : accept_dash_(accept_dash) {}
 		parsed_argument get_argument(std::string const &raw) const override;
 		std::string extract_value(std::string const & /*raw*/) const override;
 		bool requires_next_token() const override;
@@ -30,7 +30,7 @@ namespace argument_parser::conventions::implementations {
 
 	class windows_kv_argument_convention : public base_convention {
 	public:
-		explicit windows_kv_argument_convention(bool accept_dash = true);
+		constexpr explicit windows_kv_argument_convention(bool accept_dash = true) : accept_dash_(accept_dash) {}
 		parsed_argument get_argument(std::string const &raw) const override;
 		std::string extract_value(std::string const &raw) const override;
 		bool requires_next_token() const override;
@@ -53,10 +53,11 @@ namespace argument_parser::conventions::implementations {
 		windows_kv_argument_convention(bool(ALLOW_DASH_FOR_WINDOWS));
 } // namespace argument_parser::conventions::implementations
 
+// references rather than per-TU copies: the instances above are constant-initialized, so nothing runs at startup
 namespace argument_parser::conventions {
-	static inline const implementations::windows_argument_convention windows_argument_convention =
+	inline constexpr implementations::windows_argument_convention const &windows_argument_convention =
 		implementations::windows_argument_convention::instance;
-	static inline const implementations::windows_kv_argument_convention windows_equal_argument_convention =
+	inline constexpr implementations::windows_kv_argument_convention const &windows_equal_argument_convention =
 		implementations::windows_kv_argument_convention::instance;
 } // namespace argument_parser::conventions
 
@@ -0,0 +1,224 @@
+#pragma once
+#include "base_convention.hpp"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifndef STATIC_CONVENTIONS_HPP
+#define STATIC_CONVENTIONS_HPP
+
+#ifndef ALLOW_DASH_FOR_WINDOWS
+#define ALLOW_DASH_FOR_WINDOWS 1
+#endif
+
+/**
+ * Compile-time conventions for parser.handle_arguments<Conventions...>() and v2::static_parser<Conventions...>.
+ *
+ * A static convention is a type with constexpr members:
+ *   name, short_prefix, long_prefix (std::string_view), requires_next_token, interchangeable (bool),
+ *   classify(std::string_view) -> classified_token, and help_value(std::string_view option) -> std::string.
+ * Classification works on views into the token, so nothing is allocated until a token is accepted. INTERCHANGABLE
+ * names are matched case-insensitively by the parser, so conventions pass them through unchanged.
+ */
+namespace argument_parser::conventions::static_dispatch {
+	struct classified_token {
+		argument_type type = argument_type::ERROR;
+		std::string_view name;		  // the error message when type is ERROR
+		std::string_view value;		  // inline value, valid when has_value
+		bool has_value = false;
+		std::string_view value_error; // why there is no inline value
+	};
+
+	constexpr bool starts_with(std::string_view s, std::string_view prefix) noexcept {
+		return s.substr(0, prefix.size()) == prefix;
+	}
+
+	constexpr classified_token error(std::string_view message) noexcept {
+		return {argument_type::ERROR, message, {}, false, {}};
+	}
+
+	struct gnu {
+		static constexpr std::string_view name = "GNU-style long options";
+		static constexpr std::string_view short_prefix = "-";
+		static constexpr std::string_view long_prefix = "--";
+		static constexpr bool requires_next_token = true;
+		static constexpr bool interchangeable = false;
+
+		static constexpr classified_token classify(std::string_view raw) noexcept {
+			constexpr std::string_view no_value = "No inline value in standard GNU convention.";
+			if (starts_with(raw, long_prefix))
+				return {argument_type::LONG, raw.substr(long_prefix.size()), {}, false, no_value};
+			if (starts_with(raw, short_prefix))
+				return {argument_type::SHORT, raw.substr(short_prefix.size()), {}, false, no_value};
+			return error("GNU standard convention does not allow arguments without a preceding dash.");
+		}
+
+		static std::string help_value(std::string_view /*option*/) {
+			return " <value>";
+		}
+	};
+
+	struct gnu_equal {
+		static constexpr std::string_view name = "GNU-style long options (equal signed form)";
+		static constexpr std::string_view short_prefix = "-";
+		static constexpr std::string_view long_prefix = "--";
+		static constexpr bool requires_next_token = false;
+		static constexpr bool interchangeable = false;
+
+		static constexpr classified_token classify(std::string_view raw) noexcept {
+			auto pos = raw.find('=');
+			auto arg = raw.substr(0, pos);
+			classified_token token = gnu::classify(arg);
+			if (token.type == argument_type::ERROR) {
+				return token;
+			}
+			token.has_value = pos != std::string_view::npos && pos + 1 < raw.size();
+			token.value = token.has_value ? raw.substr(pos + 1) : std::string_view{};
+			token.value_error = "Expected value after '='.";
+			return token;
+		}
+
+		static std::string help_value(std::string_view /*option*/) {
+			return "=<value>";
+		}
+	};
+
+	template <bool AcceptDash = bool(ALLOW_DASH_FOR_WINDOWS)> struct windows {
+		static constexpr std::string_view name = "Windows style options (next-token values)";
+		static constexpr std::string_view short_prefix = AcceptDash ? "-" : "/";
+		static constexpr std::string_view long_prefix = "/";
+		static constexpr bool requires_next_token = true;
+		static constexpr bool interchangeable = true;
+
+		static constexpr classified_token classify(std::string_view raw) noexcept {
+			if (raw.empty()) {
+				return error("Empty argument token.");
+			}
+			if (!(raw[0] == '/' || (AcceptDash && raw[0] == '-'))) {
+				return error(AcceptDash ? "Windows-style expects options to start with '/' (or '-' in compat mode)."
+										: "Windows-style expects options to start with '/'.");
+			}
+			if (raw.find_first_of("=:") != std::string_view::npos) {
+				return error("Inline values are not allowed in this convention; provide the value in the next token.");
+			}
+			if (raw.size() == 1) {
+				return error("Option name cannot be empty after '/'.");
+			}
+			return {argument_type::INTERCHANGABLE, raw.substr(1), {}, false,
+					"No inline value; value must be provided in the next token."};
+		}
+
+		static std::string help_value(std::string_view /*option*/) {
+			return " <value>";
+		}
+	};
+
+	template <bool AcceptDash = bool(ALLOW_DASH_FOR_WINDOWS)> struct windows_kv {
+		static constexpr std::string_view name = "Windows-style options (inline values via '=' or ':')";
+		static constexpr std::string_view short_prefix = AcceptDash ? "-" : "/";
+		static constexpr std::string_view long_prefix = "/";
+		static constexpr bool requires_next_token = false;
+		static constexpr bool interchangeable = true;
+
+		static constexpr classified_token classify(std::string_view raw) noexcept {
+			if (raw.empty()) {
+				return error("Empty argument token.");
+			}
+			if (!(raw[0] == '/' || (AcceptDash && raw[0] == '-'))) {
+				return error(AcceptDash ? "Windows-style expects options to start with '/' (or '-' in compat mode)."
+										: "Windows-style expects options to start with '/'.");
+			}
+			auto sep = raw.find_first_of("=:");
+			if (sep == std::string_view::npos) {
+				return error("Expected an inline value using '=' or ':' (e.g., /opt=value or /opt:value).");
+			}
+			if (sep == 1) {
+				return error("Option name cannot be empty before '=' or ':'.");
+			}
+			bool has_value = sep + 1 < raw.size();
+			return {argument_type::INTERCHANGABLE, raw.substr(1, sep - 1),
+					has_value ? raw.substr(sep + 1) : std::string_view{}, has_value,
+					"Expected a value after '=' or ':'."};
+		}
+
+		static std::string help_value(std::string_view option) {
+			return "=<value>, " + std::string(option) + ":<value>";
+		}
+	};
+
+	/** @brief Runtime get_argument() in terms of a static convention. */
+	template <typename Convention> parsed_argument to_parsed_argument(std::string const &raw) {
+		auto token = Convention::classify(raw);
+		return {token.type, std::string(token.name)};
+	}
+
+	/** @brief Runtime extract_value() in terms of a static convention. */
+	template <typename Convention> std::string inline_value(std::string const &raw) {
+		auto token = Convention::classify(raw);
+		if (token.type == argument_type::ERROR) {
+			throw std::runtime_error(std::string(token.name));
+		}
+		if (!token.has_value) {
+			throw std::runtime_error(std::string(token.value_error));
+		}
+		return std::string(token.value);
+	}
+
+	/**
+	 * @brief base_convention view of a static convention, used where the runtime API is needed (help text, required
+	 * argument reports). Instances are constant-initialized; see runtime_convention.
+	 */
+	template <typename Convention> class static_convention_adapter final : public base_convention {
+	public:
+		constexpr static_convention_adapter() = default;
+
+		std::string extract_value(std::string const &raw) const override {
+			return inline_value<Convention>(raw);
+		}
+
+		parsed_argument get_argument(std::string const &raw) const override {
+			return to_parsed_argument<Convention>(raw);
+		}
+
+		bool requires_next_token() const override {
+			return Convention::requires_next_token;
+		}
+
+		std::string name() const override {
+			return std::string(Convention::name);
+		}
+
+		std::string short_prec() const override {
+			return std::string(Convention::short_prefix);
+		}
+
+		std::string long_prec() const override {
+			return std::string(Convention::long_prefix);
+		}
+
+		std::pair<std::string, std::string> make_help_text(std::string const &short_arg, std::string const &long_arg,
+														   bool requires_value) const override {
+			auto part = [requires_value](std::string_view prefix, std::string const &arg) {
+				if (arg == "-" || arg.empty()) {
+					return std::string{};
+				}
+				std::string option = std::string(prefix) + arg;
+				return requires_value ? option + Convention::help_value(option) : option;
+			};
+			return {part(Convention::short_prefix, short_arg), part(Convention::long_prefix, long_arg)};
+		}
+
+		std::vector<convention_features> get_features() const override {
+			if constexpr (Convention::interchangeable) {
+				return {convention_features::ALLOW_LONG_TO_SHORT_FALLBACK,
+						convention_features::ALLOW_SHORT_TO_LONG_FALLBACK};
+			} else {
+				return {};
+			}
+		}
+	};
+
+	template <typename Convention> inline constexpr static_convention_adapter<Convention> runtime_convention{};
+} // namespace argument_parser::conventions::static_dispatch
+
+#endif // STATIC_CONVENTIONS_HPP
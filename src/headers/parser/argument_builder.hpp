@@ -1,6 +1,9 @@
 #pragma once
 
 #include "argument_parser.hpp"
+#include <any>
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <parser_v2.hpp>
 #include <type_traits>
@@ -14,9 +17,25 @@ namespace argument_parser::builder {
 	namespace builder_mask {
 		using v2_flag = argument_parser::v2::add_argument_flags;
 		using mask_type = std::uint64_t;
-		enum class value_mode { unresolved, store, flag, reference, nonparametered_action, parametered_action };
+		enum class value_mode {
+			unresolved,
+			store,
+			flag,
+			reference,
+			nonparametered_action,
+			parametered_action,
+			append,
+			count
+		};
 
-		enum class extra_capability : unsigned { Store = static_cast<unsigned>(v2_flag::Reference) + 1, Flag };
+		enum class extra_capability : unsigned {
+			Store = static_cast<unsigned>(v2_flag::Count) + 1,
+			Flag,
+			Default,
+			Dependencies,
+			Validation,
+			Appending
+		};
 
 		constexpr auto bit(v2_flag flag) -> mask_type {
 			return mask_type{1} << static_cast<unsigned>(flag);
@@ -34,12 +53,18 @@ namespace argument_parser::builder {
 		constexpr mask_type action = bit(v2_flag::Action);
 		constexpr mask_type required = bit(v2_flag::Required);
 		constexpr mask_type reference = bit(v2_flag::Reference);
+		constexpr mask_type append = bit(v2_flag::Append);
+		constexpr mask_type count = bit(v2_flag::Count);
 		constexpr mask_type store = bit(extra_capability::Store);
 		constexpr mask_type flag = bit(extra_capability::Flag);
+		constexpr mask_type defaults = bit(extra_capability::Default); // unlocked by the storing value behaviors
+		constexpr mask_type dependencies = bit(extra_capability::Dependencies);
+		constexpr mask_type validation = bit(extra_capability::Validation); // unlocked by the typed value behaviors
+		constexpr mask_type appending = bit(extra_capability::Appending);	// state: append() was selected
 
-		constexpr mask_type value_mode_group = action | reference | store | flag;
-		constexpr mask_type initial =
-			short_argument | long_argument | positional | help_text | action | required | reference | store | flag;
+		constexpr mask_type value_mode_group = action | reference | store | flag | append | count;
+		constexpr mask_type initial = short_argument | long_argument | positional | help_text | action | required |
+									  reference | store | flag | append | count | dependencies;
 
 		constexpr auto has(mask_type mask, mask_type capability) -> bool {
 			return (mask & capability) == capability;
@@ -53,6 +78,18 @@ namespace argument_parser::builder {
 			return (mask & ~remove_bits) | add_bits;
 		}
 
+		constexpr auto select_storing_mode(mask_type mask) -> mask_type {
+			return replace(mask, value_mode_group, defaults);
+		}
+
+		constexpr auto select_typed_storing_mode(mask_type mask) -> mask_type {
+			return select_storing_mode(mask) | validation;
+		}
+
+		constexpr auto select_typed_mode(mask_type mask) -> mask_type {
+			return replace(mask, value_mode_group, validation);
+		}
+
 		constexpr auto has_selected_identifier(mask_type mask) -> bool {
 			return !has(mask, short_argument) || !has(mask, long_argument) || !has(mask, positional);
 		}
@@ -74,7 +111,7 @@ namespace argument_parser::builder {
 
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::short_argument), int> = 0>
-		auto short_argument(std::string short_name) const
+		auto short_argument(std::string short_name) &&
 			-> argument<builder_mask::replace(current_mask, builder_mask::short_argument | builder_mask::positional |
 																builder_mask::position),
 						store_type> {
@@ -83,14 +120,14 @@ namespace argument_parser::builder {
 																 builder_mask::position),
 						 store_type>;
 
-			next_argument next{*this};
+			next_argument next{std::move(*this)};
 			next.m_short_argument = std::move(short_name);
 			return next;
 		}
 
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::long_argument), int> = 0>
-		auto long_argument(std::string long_name) const
+		auto long_argument(std::string long_name) &&
 			-> argument<builder_mask::replace(current_mask, builder_mask::long_argument | builder_mask::positional |
 																builder_mask::position),
 						store_type> {
@@ -99,93 +136,159 @@ namespace argument_parser::builder {
 																 builder_mask::position),
 						 store_type>;
 
-			next_argument next{*this};
+			next_argument next{std::move(*this)};
 			next.m_long_argument = std::move(long_name);
 			return next;
 		}
 
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::positional), int> = 0>
-		auto positional(std::string positional_name) const
+		auto positional(std::string positional_name) &&
 			-> argument<builder_mask::replace(current_mask,
 											  builder_mask::short_argument | builder_mask::long_argument |
-												  builder_mask::positional | builder_mask::flag,
+												  builder_mask::positional | builder_mask::flag |
+												  builder_mask::append | builder_mask::count,
 											  builder_mask::position),
 						store_type> {
 			using next_argument =
 				argument<builder_mask::replace(current_mask,
 											   builder_mask::short_argument | builder_mask::long_argument |
-												   builder_mask::positional | builder_mask::flag,
+												   builder_mask::positional | builder_mask::flag |
+												   builder_mask::append | builder_mask::count,
 											   builder_mask::position),
 						 store_type>;
 
-			next_argument next{*this};
+			next_argument next{std::move(*this)};
 			next.m_positional_name = std::move(positional_name);
 			return next;
 		}
 
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::position), int> = 0>
-		auto position(int index) const
+		auto position(int index) &&
 			-> argument<builder_mask::remove(current_mask, builder_mask::position), store_type> {
 			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::position), store_type>;
 
-			next_argument next{*this};
+			next_argument next{std::move(*this)};
 			next.m_position = index;
 			return next;
 		}
 
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::help_text), int> = 0>
-		auto help_text(std::string help) const
+		auto help_text(std::string help) &&
 			-> argument<builder_mask::remove(current_mask, builder_mask::help_text), store_type> {
 			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::help_text), store_type>;
 
-			next_argument next{*this};
+			next_argument next{std::move(*this)};
 			next.m_help_text = std::move(help);
 			return next;
 		}
 
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::required), int> = 0>
-		auto required(bool value = true) const
+		auto required(bool value = true) &&
 			-> argument<builder_mask::remove(current_mask, builder_mask::required), store_type> {
 			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::required), store_type>;
 
-			next_argument next{*this};
+			next_argument next{std::move(*this)};
 			next.m_required = value;
 			return next;
 		}
 
+		template <mask_type current_mask = mask,
+				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::dependencies), int> = 0>
+		auto depends_on(std::vector<std::string> names) &&
+			-> argument<builder_mask::remove(current_mask, builder_mask::dependencies), store_type> {
+			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::dependencies), store_type>;
+
+			next_argument next{std::move(*this)};
+			next.m_dependencies = std::move(names);
+			return next;
+		}
+
 		template <typename T = std::string, mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::store), int> = 0>
-		auto store() const -> argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), T> {
+		auto store() && -> argument<builder_mask::select_typed_storing_mode(current_mask), T> {
 			static_assert(!std::is_same_v<T, void>,
 						  "store<void>() is not supported. Use flag() for boolean-style arguments.");
 
-			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), T>;
-			next_argument next{*this};
+			using next_argument = argument<builder_mask::select_typed_storing_mode(current_mask), T>;
+			next_argument next{std::move(*this)};
 			next.m_value_mode = value_mode::store;
 			return next;
 		}
 
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::flag), int> = 0>
-		auto flag() const -> argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), bool> {
-			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), bool>;
+		auto flag() && -> argument<builder_mask::select_storing_mode(current_mask), bool> {
+			using next_argument = argument<builder_mask::select_storing_mode(current_mask), bool>;
 
-			next_argument next{*this};
+			next_argument next{std::move(*this)};
 			next.m_value_mode = value_mode::flag;
 			return next;
 		}
 
+		template <typename T = std::string, mask_type current_mask = mask,
+				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::append), int> = 0>
+		auto append() && -> argument<builder_mask::select_typed_storing_mode(current_mask) | builder_mask::appending,
+									 T> {
+			static_assert(!std::is_same_v<T, void>,
+						  "append<void>() is not supported. Use count() to count occurrences.");
+
+			using next_argument =
+				argument<builder_mask::select_typed_storing_mode(current_mask) | builder_mask::appending, T>;
+			next_argument next{std::move(*this)};
+			next.m_value_mode = value_mode::append;
+			return next;
+		}
+
+		template <mask_type current_mask = mask,
+				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::count), int> = 0>
+		auto count() && -> argument<builder_mask::select_storing_mode(current_mask), int> {
+			using next_argument = argument<builder_mask::select_storing_mode(current_mask), int>;
+
+			next_argument next{std::move(*this)};
+			next.m_value_mode = value_mode::count;
+			return next;
+		}
+
+		template <mask_type current_mask = mask,
+				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::validation), int> = 0>
+		auto validate(argument_parser::validators::validator<store_type> checks) &&
+			-> argument<builder_mask::remove(current_mask, builder_mask::validation), store_type> {
+			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::validation), store_type>;
+
+			next_argument next{std::move(*this)};
+			next.m_validator = [checks = std::move(checks)](argument_parser::v2::base_parser &parser,
+															std::string const &key) {
+				parser.set_validator<store_type>(key, checks);
+			};
+			return next;
+		}
+
+		template <mask_type current_mask = mask,
+				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::defaults), int> = 0, typename Value>
+		auto default_value(Value value) &&
+			-> argument<builder_mask::remove(current_mask, builder_mask::defaults), store_type> {
+			return std::move(*this).template with_default<builder_mask::remove(current_mask, builder_mask::defaults)>(
+				[value = std::move(value)] { return value; });
+		}
+
+		template <mask_type current_mask = mask,
+				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::defaults), int> = 0, typename Factory>
+		auto default_factory(Factory factory) &&
+			-> argument<builder_mask::remove(current_mask, builder_mask::defaults), store_type> {
+			return std::move(*this).template with_default<builder_mask::remove(current_mask, builder_mask::defaults)>(
+				std::move(factory));
+		}
+
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::reference), int> = 0, typename T>
-		auto reference(T &value) const
-			-> argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), T> {
-			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), T>;
+		auto reference(T &value) && -> argument<builder_mask::select_typed_mode(current_mask), T> {
+			using next_argument = argument<builder_mask::select_typed_mode(current_mask), T>;
 
-			next_argument next{*this};
+			next_argument next{std::move(*this)};
 			next.m_reference = std::addressof(value);
 			next.m_value_mode = value_mode::reference;
 			return next;
@@ -193,40 +296,70 @@ namespace argument_parser::builder {
 
 		template <mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::action), int> = 0, typename Callable>
-		auto action(Callable &&handler) const -> std::enable_if_t<
+		auto action(Callable &&handler) && -> std::enable_if_t<
 			std::is_invocable_r_v<void, Callable>,
 			argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), non_type>> {
 			using next_argument =
 				argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), non_type>;
 
-			next_argument next{*this};
-			next.m_action = std::make_shared<argument_parser::non_parametered_action>(
-				std::function<void()>(std::forward<Callable>(handler)));
+			next_argument next{std::move(*this)};
+			next.m_action = std::make_shared<argument_parser::non_parametered_action>(std::forward<Callable>(handler));
 			next.m_value_mode = value_mode::nonparametered_action;
 			return next;
 		}
 
 		template <typename T = std::string, mask_type current_mask = mask,
 				  std::enable_if_t<builder_mask::has(current_mask, builder_mask::action), int> = 0, typename Callable>
-		auto action(Callable &&handler) const
+		auto action(Callable &&handler) &&
 			-> std::enable_if_t<std::is_invocable_r_v<void, Callable, const T &>,
-								argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), T>> {
+								argument<builder_mask::select_typed_mode(current_mask), T>> {
 			static_assert(!std::is_same_v<T, void>,
 						  "action<void>(...) is not supported. Use action([] { ... }) instead.");
 
-			using next_argument = argument<builder_mask::remove(current_mask, builder_mask::value_mode_group), T>;
+			using next_argument = argument<builder_mask::select_typed_mode(current_mask), T>;
 
-			next_argument next{*this};
-			next.m_action = std::make_shared<argument_parser::parametered_action<T>>(
-				std::function<void(const T &)>(std::forward<Callable>(handler)));
+			next_argument next{std::move(*this)};
+			next.m_action = std::make_shared<argument_parser::parametered_action<T>>(std::forward<Callable>(handler));
 			next.m_value_mode = value_mode::parametered_action;
 			return next;
 		}
 
 		template <mask_type current_mask = mask, std::enable_if_t<builder_mask::is_buildable(current_mask), int> = 0>
-		auto build(argument_parser::v2::base_parser &parser) const -> void {
+		auto build(argument_parser::v2::base_parser &parser) && -> void {
 			assert_has_identifier();
+			// the names are moved into the registration, so the key is taken first when something still needs it
+			std::string const key = m_default || !m_dependencies.empty() || m_validator ? lookup_key() : std::string{};
+
+			build_value(parser);
+			if (m_default) {
+				parser.set_default_factory(key, m_default);
+			}
+			if (!m_dependencies.empty()) {
+				parser.add_action_dependencies(key, m_dependencies);
+			}
+			if (m_validator) {
+				m_validator(parser, key);
+			}
+		}
+
+		/** @brief True when build() registers a positional argument rather than a named option. */
+		[[nodiscard]] auto is_positional() const -> bool {
+			return !m_positional_name.empty();
+		}
+
+	private:
+		argument() = default;
 
+		template <mask_type other_mask, typename other_store_type>
+		argument(argument<other_mask, other_store_type> &&other)
+			: m_short_argument(std::move(other.m_short_argument)), m_long_argument(std::move(other.m_long_argument)),
+			  m_positional_name(std::move(other.m_positional_name)), m_position(other.m_position),
+			  m_help_text(std::move(other.m_help_text)), m_required(other.m_required),
+			  m_action(std::move(other.m_action)), m_reference(copy_reference(other.m_reference)),
+			  m_value_mode(other.m_value_mode), m_default(std::move(other.m_default)),
+			  m_dependencies(std::move(other.m_dependencies)), m_validator(std::move(other.m_validator)) {}
+
+		auto build_value(argument_parser::v2::base_parser &parser) -> void {
 			switch (m_value_mode) {
 			case value_mode::flag:
 				build_flag(parser);
@@ -252,6 +385,15 @@ namespace argument_parser::builder {
 					return;
 				}
 				break;
+			case value_mode::append:
+				if constexpr (!std::is_same_v<store_type, non_type>) {
+					build_append(parser);
+					return;
+				}
+				break;
+			case value_mode::count:
+				build_count(parser);
+				return;
 			case value_mode::unresolved:
 				if (is_positional()) {
 					build_default_positional(parser);
@@ -264,25 +406,43 @@ namespace argument_parser::builder {
 			throw std::logic_error("The builder reached build() without a supported terminal value mode.");
 		}
 
-	private:
-		argument() = default;
+		template <mask_type next_mask, typename Factory>
+		auto with_default(Factory factory) && -> argument<next_mask, store_type> {
+			using result_type = std::invoke_result_t<Factory &>;
 
-		template <mask_type other_mask, typename other_store_type>
-		argument(argument<other_mask, other_store_type> const &other)
-			: m_short_argument(other.m_short_argument), m_long_argument(other.m_long_argument),
-			  m_positional_name(other.m_positional_name), m_position(other.m_position), m_help_text(other.m_help_text),
-			  m_required(other.m_required), m_action(other.m_action), m_reference(copy_reference(other.m_reference)),
-			  m_value_mode(other.m_value_mode) {}
+			argument<next_mask, store_type> next{std::move(*this)};
+			if constexpr (builder_mask::has(next_mask, builder_mask::appending)) {
+				static_assert(std::is_convertible_v<result_type, std::vector<store_type>>,
+							  "Defaults of append() arguments must be convertible to std::vector<T>.");
+				next.m_default = [factory]() mutable { return std::any{std::vector<store_type>(factory())}; };
+			} else {
+				static_assert(std::is_convertible_v<result_type, store_type>,
+							  "Default value is not convertible to the stored type.");
+				next.m_default = [factory]() mutable { return std::any{store_type(factory())}; };
+			}
+			return next;
+		}
 
-		template <typename T>
-		using typed_map =
-			std::unordered_map<v2_flag, typename argument_parser::v2::base_parser::template typed_flag_value<T>>;
+		/** @brief The values handed to the parser, indexed by flag, so registering needs no pair container. */
+		template <typename Value> struct flag_values {
+			flag_values() = default;
+			flag_values(flag_values const &) = delete; // slots point into values
+			flag_values &operator=(flag_values const &) = delete;
 
-		using non_typed_map = std::unordered_map<v2_flag, argument_parser::v2::base_parser::non_typed_flag_value>;
+			void set(v2_flag flag, Value value) {
+				auto &slot = values[static_cast<std::size_t>(flag)];
+				slot = std::move(value);
+				slots.set(flag, slot);
+			}
 
-		auto is_positional() const -> bool {
-			return !m_positional_name.empty();
-		}
+			std::array<Value, static_cast<std::size_t>(v2_flag::Count) + 1> values{};
+			argument_parser::v2::flag_slots<Value> slots;
+		};
+
+		template <typename T>
+		using typed_values = flag_values<typename argument_parser::v2::base_parser::template typed_flag_value<T>>;
+
+		using non_typed_values = flag_values<argument_parser::v2::base_parser::non_typed_flag_value>;
 
 		auto lookup_key() const -> std::string {
 			if (is_positional()) {
@@ -304,102 +464,123 @@ namespace argument_parser::builder {
 			}
 		}
 
-		template <typename Map> auto add_common_pairs(Map &pairs) const -> void {
+		template <typename Values> auto add_common_values(Values &values) -> void {
 			using namespace argument_parser::v2::flags;
 
 			if (is_positional()) {
-				pairs[Positional] = m_positional_name;
+				values.set(Positional, std::move(m_positional_name));
 				if (m_position.has_value()) {
-					pairs[Position] = m_position.value();
+					values.set(Position, m_position.value());
 				}
 			} else {
 				if (!m_short_argument.empty()) {
-					pairs[ShortArgument] = m_short_argument;
+					values.set(ShortArgument, std::move(m_short_argument));
 				}
 				if (!m_long_argument.empty()) {
-					pairs[LongArgument] = m_long_argument;
+					values.set(LongArgument, std::move(m_long_argument));
 				}
 			}
 
 			if (!m_help_text.empty()) {
-				pairs[HelpText] = m_help_text;
+				values.set(HelpText, std::move(m_help_text));
 			}
 			if (m_required) {
-				pairs[Required] = true;
+				values.set(Required, true);
 			}
 		}
 
-		template <typename T> auto make_typed_pairs() const -> typed_map<T> {
-			typed_map<T> pairs;
-			add_common_pairs(pairs);
-			return pairs;
+		auto build_flag(argument_parser::v2::base_parser &parser) -> void {
+			non_typed_values values;
+			add_common_values(values);
+			parser.add_argument(std::move(values.slots));
 		}
 
-		auto make_non_typed_pairs() const -> non_typed_map {
-			non_typed_map pairs;
-			add_common_pairs(pairs);
-			return pairs;
+		auto build_default_positional(argument_parser::v2::base_parser &parser) -> void {
+			non_typed_values values;
+			add_common_values(values);
+			parser.add_argument(std::move(values.slots));
 		}
 
-		auto build_flag(argument_parser::v2::base_parser &parser) const -> void {
-			auto pairs = make_non_typed_pairs();
-			parser.add_argument(pairs);
+		auto build_store(argument_parser::v2::base_parser &parser) -> void {
+			typed_values<store_type> values;
+			add_common_values(values);
+			parser.template add_argument<store_type>(std::move(values.slots));
 		}
 
-		auto build_default_positional(argument_parser::v2::base_parser &parser) const -> void {
-			auto pairs = make_non_typed_pairs();
-			parser.add_argument(pairs);
+		auto build_append(argument_parser::v2::base_parser &parser) -> void {
+			typed_values<store_type> values;
+			add_common_values(values);
+			values.set(argument_parser::v2::flags::Append, true);
+			parser.template add_argument<store_type>(std::move(values.slots));
 		}
 
-		auto build_store(argument_parser::v2::base_parser &parser) const -> void {
-			auto pairs = make_typed_pairs<store_type>();
-			parser.template add_argument<store_type>(pairs);
+		auto build_count(argument_parser::v2::base_parser &parser) -> void {
+			non_typed_values values;
+			add_common_values(values);
+			values.set(argument_parser::v2::flags::Count, true);
+			parser.add_argument(std::move(values.slots));
 		}
 
-		auto build_reference(argument_parser::v2::base_parser &parser) const -> void {
-			auto pairs = make_typed_pairs<store_type>();
-			auto *target = m_reference;
-			auto key = lookup_key();
-
-			if (target == nullptr) {
+		auto build_reference(argument_parser::v2::base_parser &parser) -> void {
+			if (m_reference == nullptr) {
 				throw std::logic_error("reference() was selected without a target.");
 			}
 
-			pairs[argument_parser::v2::flags::Reference] = target;
-			parser.template add_argument<store_type>(pairs);
+			typed_values<store_type> values;
+			add_common_values(values);
+			values.set(argument_parser::v2::flags::Reference, m_reference);
+			parser.template add_argument<store_type>(std::move(values.slots));
 		}
 
-		auto build_parametered_action(argument_parser::v2::base_parser &parser) const -> void {
-			auto const *typed_action =
-				dynamic_cast<argument_parser::parametered_action<store_type> const *>(m_action.get());
+		auto build_parametered_action(argument_parser::v2::base_parser &parser) -> void {
+			using action_type = argument_parser::parametered_action<store_type>;
+			auto *typed_action = dynamic_cast<action_type *>(m_action.get());
 			if (typed_action == nullptr) {
 				throw std::logic_error("Stored action is not compatible with the requested parameter type.");
 			}
 
-			auto pairs = make_typed_pairs<store_type>();
-			pairs[argument_parser::v2::flags::Action] = *typed_action;
-			parser.template add_argument<store_type>(pairs);
+			typed_values<store_type> values;
+			add_common_values(values);
+			if (m_action.use_count() == 1) {
+				values.set(argument_parser::v2::flags::Action, std::move(*typed_action));
+			} else { // a copy of this builder still holds the action, so the registration shares it
+				values.set(argument_parser::v2::flags::Action,
+						   argument_parser::helpers::make_parametered_action<store_type>(
+							   [action = std::static_pointer_cast<action_type const>(m_action)](
+								   store_type const &value) { action->invoke(value); }));
+			}
+			parser.template add_argument<store_type>(std::move(values.slots));
 		}
 
-		auto build_nonparametered_action(argument_parser::v2::base_parser &parser) const -> void {
-			auto const *nonparametered_action =
-				dynamic_cast<argument_parser::non_parametered_action const *>(m_action.get());
+		auto build_nonparametered_action(argument_parser::v2::base_parser &parser) -> void {
+			auto *nonparametered_action = dynamic_cast<argument_parser::non_parametered_action *>(m_action.get());
 			if (nonparametered_action == nullptr) {
 				throw std::logic_error("Stored action is not a non-parametered action.");
 			}
 
 			if (is_positional()) {
+				// shares the stored action instead of moving it into the wrapper
 				auto wrapped_action = argument_parser::helpers::make_parametered_action<std::string>(
-					[action = *nonparametered_action](std::string const &) { action.invoke(); });
-				auto pairs = make_typed_pairs<std::string>();
-				pairs[argument_parser::v2::flags::Action] = wrapped_action;
-				parser.template add_argument<std::string>(pairs);
+					[action = std::static_pointer_cast<argument_parser::non_parametered_action const>(m_action)](
+						std::string const &) { action->invoke(); });
+				typed_values<std::string> values;
+				add_common_values(values);
+				values.set(argument_parser::v2::flags::Action, std::move(wrapped_action));
+				parser.template add_argument<std::string>(std::move(values.slots));
 				return;
 			}
 
-			auto pairs = make_non_typed_pairs();
-			pairs[argument_parser::v2::flags::Action] = *nonparametered_action;
-			parser.add_argument(pairs);
+			non_typed_values values;
+			add_common_values(values);
+			if (m_action.use_count() == 1) {
+				values.set(argument_parser::v2::flags::Action, std::move(*nonparametered_action));
+			} else { // a copy of this builder still holds the action, so the registration shares it
+				values.set(argument_parser::v2::flags::Action,
+						   argument_parser::helpers::make_non_parametered_action(
+							   [action = std::static_pointer_cast<argument_parser::non_parametered_action const>(
+									m_action)] { action->invoke(); }));
+			}
+			parser.add_argument(std::move(values.slots));
 		}
 
 		std::string m_short_argument{};
@@ -408,9 +589,12 @@ namespace argument_parser::builder {
 		std::optional<int> m_position{};
 		std::string m_help_text{};
 		bool m_required = false;
-		std::shared_ptr<argument_parser::action_base const> m_action{};
+		std::shared_ptr<argument_parser::action_base> m_action{};
 		store_type *m_reference = nullptr;
 		value_mode m_value_mode = value_mode::unresolved;
+		std::function<std::any()> m_default{};
+		std::vector<std::string> m_dependencies{};
+		std::function<void(argument_parser::v2::base_parser &, std::string const &)> m_validator{};
 
 		template <typename other_store_type> static auto copy_reference(other_store_type *reference) -> store_type * {
 			if constexpr (std::is_same_v<store_type, other_store_type>) {
@@ -423,6 +607,22 @@ namespace argument_parser::builder {
 		template <mask_type other_mask, typename other_store_type> friend class argument;
 	};
 
+	/**
+	 * @brief Builds every builder into parser after making room for all of them at once.
+	 *
+	 * Like build(), it consumes the builders, so they are passed as temporaries or with std::move:
+	 * build_all(parser, argument<>::start().long_argument("port").store<int>(), std::move(path_builder));
+	 */
+	template <typename... Builders>
+	auto build_all(argument_parser::v2::base_parser &parser, Builders &&...builders) -> void {
+		static_assert((!std::is_lvalue_reference_v<Builders> && ...),
+					  "build_all() consumes its builders; pass temporaries or std::move them.");
+
+		std::size_t const positionals = (std::size_t{0} + ... + (builders.is_positional() ? 1 : 0));
+		parser.reserve(sizeof...(Builders) - positionals, positionals);
+		(std::move(builders).build(parser), ...);
+	}
+
 	namespace assertions {
 		struct noop_handler {
 			void operator()() const {}
@@ -465,6 +665,33 @@ namespace argument_parser::builder {
 		template <typename T>
 		struct can_use_flag<T, std::void_t<decltype(std::declval<T>().flag())>> : std::true_type {};
 
+		template <typename T, typename U, typename = void> struct can_use_append : std::false_type {};
+
+		template <typename T, typename U>
+		struct can_use_append<T, U, std::void_t<decltype(std::declval<T>().template append<U>())>> : std::true_type {};
+
+		template <typename T, typename = void> struct can_use_count : std::false_type {};
+
+		template <typename T>
+		struct can_use_count<T, std::void_t<decltype(std::declval<T>().count())>> : std::true_type {};
+
+		template <typename T, typename = void> struct can_use_default_value : std::false_type {};
+
+		template <typename T>
+		struct can_use_default_value<T, std::void_t<decltype(std::declval<T>().default_value(0))>> : std::true_type {};
+
+		template <typename T, typename U, typename = void> struct can_use_validate : std::false_type {};
+
+		template <typename T, typename U>
+		struct can_use_validate<
+			T, U, std::void_t<decltype(std::declval<T>().validate(std::declval<validators::validator<U>>()))>>
+			: std::true_type {};
+
+		template <typename T, typename = void> struct can_use_depends_on : std::false_type {};
+
+		template <typename T>
+		struct can_use_depends_on<T, std::void_t<decltype(std::declval<T>().depends_on({}))>> : std::true_type {};
+
 		template <typename T, typename U, typename = void> struct can_use_reference : std::false_type {};
 
 		template <typename T, typename U>
@@ -474,6 +701,18 @@ namespace argument_parser::builder {
 		using after_help_text = decltype(argument<>::start().help_text("help"));
 		static_assert(!can_use_help_text<after_help_text>::value, "help_text() should be single-use.");
 
+		static_assert(!can_use_validate<argument<>, std::string>::value,
+					  "validate() should require a typed value behavior.");
+		using after_store_int = decltype(argument<>::start().long_argument("port").store<int>());
+		static_assert(can_use_validate<after_store_int, int>::value, "store<T>() should unlock validate().");
+		using after_validate = decltype(std::declval<after_store_int>().validate({validators::range(1, 65535)}));
+		static_assert(!can_use_validate<after_validate, int>::value, "validate() should be single-use.");
+		using after_flag = decltype(argument<>::start().long_argument("verbose").flag());
+		static_assert(!can_use_validate<after_flag, bool>::value, "flag() should not unlock validate().");
+
+		using after_depends_on = decltype(argument<>::start().depends_on({"config"}));
+		static_assert(!can_use_depends_on<after_depends_on>::value, "depends_on() should be single-use.");
+
 		using after_positional = decltype(argument<>::start().positional("path"));
 		static_assert(can_use_position<after_positional>::value, "positional() should unlock position().");
 
@@ -484,6 +723,23 @@ namespace argument_parser::builder {
 		static_assert(!can_use_flag<after_positional_mode_selection>::value,
 					  "flag() should not be available for positional arguments.");
 
+		using after_positional_name = decltype(argument<>::start().positional("path"));
+		static_assert(!can_use_append<after_positional_name, int>::value,
+					  "append() should not be available for positional arguments.");
+		static_assert(!can_use_count<after_positional_name>::value,
+					  "count() should not be available for positional arguments.");
+
+		static_assert(!can_use_default_value<after_positional_name>::value,
+					  "default_value() should require a storing value behavior.");
+		static_assert(can_use_default_value<after_positional_mode_selection>::value,
+					  "store() should unlock default_value().");
+		using after_default_value = decltype(argument<>::start().long_argument("jobs").store<int>().default_value(1));
+		static_assert(!can_use_default_value<after_default_value>::value, "default_value() should be single-use.");
+
+		using after_append = decltype(argument<>::start().short_argument("I").append<std::string>());
+		static_assert(!can_use_store<after_append, int>::value && !can_use_count<after_append>::value,
+					  "append() should be mutually exclusive with the other value behaviors.");
+
 		using after_nonparametered_action =
 			decltype(argument<>::start().short_argument("v").help_text("verbose").action(noop_handler{}));
 		static_assert(!can_use_nonparametered_action<after_nonparametered_action>::value,
@@ -5,18 +5,33 @@
 #include <any>
 #include <atomic>
 #include <base_convention.hpp>
+#include <constraints.hpp>
+#include <diagnostics.hpp>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <initializer_list>
+#include <instrumentation.hpp>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <name_index.hpp>
 #include <optional>
+#include <parse_cache.hpp>
+#include <parse_image.hpp>
+#include <small_function.hpp>
+#include <sstream>
+#include <static_conventions.hpp>
 #include <stdexcept>
 #include <string>
+#include <string_pool.hpp>
+#include <string_view>
 #include <thread>
 #include <traits.hpp>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <validators.hpp>
 #include <vector>
 
 namespace argument_parser {
@@ -97,14 +112,18 @@ namespace argument_parser {
 		virtual ~action_base() = default;
 		[[nodiscard]] virtual bool expects_parameter() const = 0;
 		virtual void invoke() const = 0;
-		virtual void invoke_with_parameter(const std::string &param) const = 0;
+		/** @brief False when a fail_skip validator dropped the value, leaving the option as if it was not given. */
+		virtual bool invoke_with_parameter(const std::string &param) const = 0;
+		/** @brief Converts and validates like invoke_with_parameter without calling the handler. */
+		virtual bool check_parameter(const std::string &param) const = 0;
 		[[nodiscard]] virtual std::pair<std::string, std::string> get_trait_hints() const = 0;
-		[[nodiscard]] virtual std::unique_ptr<action_base> clone() const = 0;
 	};
 
 	template <typename T> class parametered_action : public action_base {
 	public:
-		explicit parametered_action(std::function<void(const T &)> const &handler) : handler(handler) {}
+		using handler_type = internal::small_function<void(const T &)>;
+
+		explicit parametered_action(handler_type handler) : handler(std::move(handler)) {}
 		using parameter_type = T;
 		void invoke(const T &arg) const {
 			handler(arg);
@@ -118,12 +137,49 @@ namespace argument_parser {
 			throw std::runtime_error("Parametered action requires a parameter");
 		}
 
-		void invoke_with_parameter(const std::string &param) const override {
+		bool invoke_with_parameter(const std::string &param) const override {
+			return convert(param, true);
+		}
+
+		bool check_parameter(const std::string &param) const override {
+			return convert(param, false);
+		}
+
+		/** @brief Runs between parser_trait<T>::parse and the handler. Shared, never copied, by copies. */
+		void set_validation(std::shared_ptr<validators::validator<T> const> checks) {
+			validation = std::move(checks);
+		}
+
+		[[nodiscard]] std::pair<std::string, std::string> get_trait_hints() const override {
+			if constexpr (internal::sfinae::has_format_hint<parsing_traits::parser_trait<T>>::value &&
+						  internal::sfinae::has_purpose_hint<parsing_traits::parser_trait<T>>::value) {
+				return {parsing_traits::parser_trait<T>::format_hint, parsing_traits::parser_trait<T>::purpose_hint};
+			} else {
+				return {"", "value"};
+			}
+		}
+
+	private:
+		bool convert(const std::string &param, bool call_handler) const {
 			bool parse_success = false;
+			bool accepted = false;
+			std::string rejection;
 			try {
-				T parsed_value = parsing_traits::parser_trait<T>::parse(param);
+				T parsed_value = [&param] {
+					auto const option = instrumentation::detail::active_option;
+					instrumentation::trace_span span("parse", option.empty() ? parse_span_name() : option);
+					return parsing_traits::parser_trait<T>::parse(param);
+				}();
 				parse_success = true;
-				invoke(parsed_value);
+				auto const *rejected_by = validation ? validation->rejecting(parsed_value) : nullptr;
+				if (rejected_by == nullptr) {
+					if (call_handler) {
+						invoke(parsed_value);
+					}
+					accepted = true;
+				} else if (validation->policy() == validators::failure_policy::fail_loud) {
+					rejection = "'" + param + "' is not accepted ${KEY}: " + rejected_by->description();
+				}
 			} catch (const std::runtime_error &e) {
 				if (!parse_success) {
 					auto [format_hint, purpose_hint] = get_trait_hints();
@@ -135,28 +191,29 @@ namespace argument_parser {
 					throw std::runtime_error(error_text);
 				}
 			}
+			if (!rejection.empty()) {
+				throw std::runtime_error(rejection);
+			}
+			return accepted;
 		}
 
-		[[nodiscard]] std::pair<std::string, std::string> get_trait_hints() const override {
-			if constexpr (internal::sfinae::has_format_hint<parsing_traits::parser_trait<T>>::value &&
-						  internal::sfinae::has_purpose_hint<parsing_traits::parser_trait<T>>::value) {
-				return {parsing_traits::parser_trait<T>::format_hint, parsing_traits::parser_trait<T>::purpose_hint};
+		static constexpr const char *parse_span_name() {
+			if constexpr (internal::sfinae::has_purpose_hint<parsing_traits::parser_trait<T>>::value) {
+				return parsing_traits::parser_trait<T>::purpose_hint;
 			} else {
-				return {"", "value"};
+				return "value";
 			}
 		}
 
-		[[nodiscard]] std::unique_ptr<action_base> clone() const override {
-			return std::make_unique<parametered_action<T>>(handler);
-		}
-
-	private:
-		std::function<void(const T &)> handler;
+		handler_type handler;
+		std::shared_ptr<validators::validator<T> const> validation;
 	};
 
 	class non_parametered_action : public action_base {
 	public:
-		explicit non_parametered_action(std::function<void()> const &handler) : handler(handler) {}
+		using handler_type = internal::small_function<void()>;
+
+		explicit non_parametered_action(handler_type handler) : handler(std::move(handler)) {}
 
 		void invoke() const override {
 			handler();
@@ -166,34 +223,70 @@ namespace argument_parser {
 			return false;
 		}
 
-		void invoke_with_parameter(const std::string &param) const override {
+		bool invoke_with_parameter(const std::string & /*param*/) const override {
 			invoke();
+			return true;
 		}
 
-		[[nodiscard]] std::pair<std::string, std::string> get_trait_hints() const override {
-			return {"", ""};
+		bool check_parameter(const std::string & /*param*/) const override {
+			return true;
 		}
 
-		[[nodiscard]] std::unique_ptr<action_base> clone() const override {
-			return std::make_unique<non_parametered_action>(handler);
+		[[nodiscard]] std::pair<std::string, std::string> get_trait_hints() const override {
+			return {"", ""};
 		}
 
 	private:
-		std::function<void()> handler;
+		handler_type handler;
 	};
 
 	class base_parser;
 
+	enum class accumulation_mode { none, append, count };
+
+	/**
+	 * @brief A default help text kept as pointers to string constants (usually parser_trait<T> hints) and only
+	 * formatted when help is rendered.
+	 */
+	struct generated_help {
+		enum class form : std::uint8_t { none, literal, accepts, accepts_repeated, triggers_action };
+
+		form shape = form::none;
+		char const *text = nullptr;	   // literal
+		char const *purpose = nullptr; // trait hints; "value" is used when the trait has none
+		char const *format = nullptr;
+
+		template <typename T> static generated_help from_trait(form shape) {
+			using trait = parsing_traits::parser_trait<T>;
+			if constexpr (internal::sfinae::has_format_hint<trait>::value &&
+						  internal::sfinae::has_purpose_hint<trait>::value) {
+				return {shape, nullptr, trait::purpose_hint, trait::format_hint};
+			} else {
+				return {shape, nullptr, nullptr, nullptr};
+			}
+		}
+
+		static generated_help literal(char const *text) {
+			return {form::literal, text, nullptr, nullptr};
+		}
+
+		[[nodiscard]] std::string render() const;
+	};
+
 	class argument {
 	public:
 		argument();
 
 		template <typename ActionType>
-		argument(const int id, std::string name, ActionType const &action)
-			: id(id), name(std::move(name)), action(action.clone()), required(false), invoked(false) {}
-
-		argument(const argument &other);
-		argument &operator=(const argument &other);
+		argument(const int id, std::string_view name, ActionType &&action)
+			: id(id), name(name), action(std::make_unique<std::decay_t<ActionType>>(std::forward<ActionType>(action))),
+			  required(false), invoked(false) {}
+		// name must outlive the argument; intern it in the parser's string pool first
+		template <typename ActionType> argument(const int id, std::string &&name, ActionType &&action) = delete;
+
+		// arguments live in the parser's argument_map and are only ever referenced from there
+		argument(const argument &other) = delete;
+		argument &operator=(const argument &other) = delete;
 		argument(argument &&other) noexcept = default;
 		argument &operator=(argument &&other) noexcept = default;
 
@@ -204,37 +297,84 @@ namespace argument_parser {
 		[[nodiscard]] std::string get_help_text() const;
 		[[nodiscard]] bool is_positional() const;
 		[[nodiscard]] std::optional<int> get_position_index() const;
+		[[nodiscard]] accumulation_mode get_accumulation() const;
+		/** @brief True for options whose action only records the value in the parser (no user action). */
+		[[nodiscard]] bool is_storing() const;
 
 	private:
 		void set_required(bool val);
 		void set_invoked(bool val);
-		void set_help_text(std::string const &text);
+		void set_help_text(std::string_view text);
 		void set_positional(bool val);
 		void set_position_index(std::optional<int> idx);
+		void set_accumulation(accumulation_mode mode);
+		void set_storing(bool val);
 
 		friend class base_parser;
 
 		int id;
-		std::string name;
+		std::string_view name; // "short|long" or the positional name, owned by the parser's string pool
+		std::size_t index = 0; // dense, in registration order; the bit of this argument in constraint masks
 		std::unique_ptr<action_base> action;
 		bool required;
 		bool invoked;
-		std::string help_text;
+		std::string_view help_text;
+		generated_help default_help; // rendered when help_text is empty
 		bool positional = false;
 		std::optional<int> position_index = std::nullopt;
+		accumulation_mode accumulation = accumulation_mode::none;
+		bool storing = false;
 	};
 
 	namespace helpers {
-		template <typename T>
-		static parametered_action<T> make_parametered_action(std::function<void(const T &)> const &function) {
-			return parametered_action<T>(function);
+		template <typename T, typename Callable>
+		static parametered_action<T> make_parametered_action(Callable &&function) {
+			return parametered_action<T>(std::forward<Callable>(function));
 		}
 
-		static non_parametered_action make_non_parametered_action(std::function<void()> const &function) {
-			return non_parametered_action(function);
+		template <typename Callable> static non_parametered_action make_non_parametered_action(Callable &&function) {
+			return non_parametered_action(std::forward<Callable>(function));
 		}
 	} // namespace helpers
 
+	/**
+	 * @brief Thrown by handle_arguments() when required arguments are missing or a constraint group is violated.
+	 * Parsers that exit on failure (the platform parsers) print what() and the help text instead.
+	 */
+	class requirement_error : public std::runtime_error {
+	public:
+		requirement_error(std::string const &report, std::vector<std::size_t> missing_indices,
+						  std::vector<std::string> missing_names, std::vector<std::size_t> violated)
+			: std::runtime_error(report), missing_indices(std::move(missing_indices)),
+			  missing_names(std::move(missing_names)), violated(std::move(violated)) {}
+
+		/** @brief Dense indices of the missing required arguments, in registration order. */
+		[[nodiscard]] std::vector<std::size_t> const &missing() const noexcept {
+			return missing_indices;
+		}
+
+		/** @brief The missing arguments as "s, long" or "<positional>", parallel to missing(). */
+		[[nodiscard]] std::vector<std::string> const &missing_arguments() const noexcept {
+			return missing_names;
+		}
+
+		/** @brief Numbers of the violated constraint groups, in the order they were added. */
+		[[nodiscard]] std::vector<std::size_t> const &violated_constraints() const noexcept {
+			return violated;
+		}
+
+	private:
+		std::vector<std::size_t> missing_indices;
+		std::vector<std::string> missing_names;
+		std::vector<std::size_t> violated;
+	};
+
+	/** @brief How a --long token may name a registered long option besides its exact spelling. */
+	struct name_matching {
+		bool ignore_case = false;
+		bool unique_prefix = false; // getopt_long-style abbreviations: --verb for --verbose
+	};
+
 	/**
 	 * @brief Base class for parsing arguments from the command line.
 	 *
@@ -246,8 +386,8 @@ namespace argument_parser {
 	public:
 		template <typename T>
 		void add_argument(std::string const &short_arg, std::string const &long_arg, std::string const &help_text,
-						  parametered_action<T> const &action, bool required) {
-			base_add_argument(short_arg, long_arg, help_text, action, required);
+						  parametered_action<T> action, bool required) {
+			base_add_argument(short_arg, long_arg, help_text, std::move(action), required);
 		}
 
 		template <typename T>
@@ -257,8 +397,8 @@ namespace argument_parser {
 		}
 
 		void add_argument(std::string const &short_arg, std::string const &long_arg, std::string const &help_text,
-						  non_parametered_action const &action, bool required) {
-			base_add_argument(short_arg, long_arg, help_text, action, required);
+						  non_parametered_action action, bool required) {
+			base_add_argument(short_arg, long_arg, help_text, std::move(action), required);
 		}
 
 		void add_argument(std::string const &short_arg, std::string const &long_arg, std::string const &help_text,
@@ -266,11 +406,27 @@ namespace argument_parser {
 			base_add_argument<void>(short_arg, long_arg, help_text, required);
 		}
 
+		/**
+		 * @brief Collects every occurrence into a std::vector<T>, read back with get_optional<std::vector<T>>().
+		 * The vector is reserved once per parse from the number of occurrences on the command line.
+		 */
+		template <typename T>
+		void add_appending_argument(std::string const &short_arg, std::string const &long_arg,
+									std::string const &help_text, bool required) {
+			base_add_appending_argument<T>(short_arg, long_arg, help_text, required);
+		}
+
+		/**
+		 * @brief Counts occurrences as an int, read back with get_optional<int>(). "-vvv" counts three for "-v".
+		 */
+		void add_counting_argument(std::string const &short_arg, std::string const &long_arg,
+								   std::string const &help_text, bool required);
+
 		template <typename T>
 		void add_positional_argument(std::string const &name, std::string const &help_text,
-									 parametered_action<T> const &action, bool required,
+									 parametered_action<T> action, bool required,
 									 std::optional<int> position = std::nullopt) {
-			base_add_positional_argument(name, help_text, action, required, position);
+			base_add_positional_argument(name, help_text, std::move(action), required, position);
 		}
 
 		template <typename T>
@@ -281,24 +437,210 @@ namespace argument_parser {
 
 		void on_complete(std::function<void(base_parser const &)> const &action);
 
+		/**
+		 * @brief Registers a named on_complete handler that runs on its own thread once parsing has finished.
+		 *
+		 * The handler starts after the plain on_complete handlers and after every handler named in `after`, which
+		 * must already be registered. If one of those throws, this handler does not run and its future carries the
+		 * same exception. handle_arguments() does not wait; use completion(name) or wait().
+		 */
+		void on_complete_async(std::string const &name, std::function<void(base_parser const &)> const &handler,
+							   std::vector<std::string> const &after = {});
+		[[nodiscard]] std::shared_future<void> completion(std::string const &name) const;
+		/**
+		 * @brief Blocks until every on_complete_async handler of the last parse has finished and rethrows the first
+		 * failure in registration order.
+		 */
+		void wait() const;
+
+		/**
+		 * @brief Registers a subcommand whose options are materialized lazily.
+		 *
+		 * Only the name, help text and factory are stored. When the first positional token matches a registered name,
+		 * the factory runs against this parser and its options join the parent options already registered here. The
+		 * factory may register further subcommands, which then form the next level; the first positional token after
+		 * a selection may select from it. The next parse undoes the selection: everything the factories registered is
+		 * removed again and the top-level subcommands are offered anew.
+		 */
+		void add_subcommand(std::string const &name, std::string const &help_text,
+							std::function<void(base_parser &)> const &factory);
+		[[nodiscard]] std::vector<std::string> const &subcommand_path() const;
+		/**
+		 * @brief Runs registrations as a unit: if they throw, every option, positional argument, constraint, handler
+		 * and subcommand they registered is removed again before the exception propagates.
+		 */
+		void register_atomically(std::function<void()> const &registrations);
+
+		/**
+		 * @brief Runs matched actions on a pool of threads instead of one by one in command-line order.
+		 *
+		 * Repeated occurrences of an option stay ordered on a single thread, and an action only starts once every
+		 * present option it depends on (see add_action_dependencies) has finished. Dependents of a failed action are
+		 * skipped. Errors are aggregated as in the serial mode. max_threads == 0 uses the hardware concurrency.
+		 */
+		void set_concurrent_actions(bool enabled, unsigned max_threads = 0);
+		void add_action_dependencies(std::string const &arg, std::vector<std::string> const &dependencies);
+
+		/**
+		 * @brief Constraints on which arguments appear together, checked with the required arguments after every
+		 * parse. Names are any spelling of an option or a positional name; unknown names throw std::runtime_error.
+		 * Groups are numbered in the order they are added, as requirement_error::violated_constraints() reports them.
+		 */
+		void add_mutually_exclusive_group(std::vector<std::string> const &names);
+		void add_at_least_one_group(std::vector<std::string> const &names);
+		/** @brief When arg is present, every argument in required must be present as well. */
+		void add_requirements(std::string const &arg, std::vector<std::string> const &required);
+
+		/**
+		 * @brief Enables case-insensitive and/or unique-prefix matching for --long tokens. Windows-style tokens always
+		 * match case-insensitively. An exact spelling wins; an ambiguous prefix fails with every candidate listed.
+		 */
+		void set_long_name_matching(name_matching matching);
+
+		/**
+		 * @brief Parses without side effects outside the parser. Stored options record their values and every value
+		 * is still converted and validated, but user actions, the help action and on_complete handlers do not run.
+		 */
+		void set_dry_run(bool enabled);
+
+		/**
+		 * @brief Whether missing required arguments and violated constraint groups print the report and help and
+		 * exit(1) (the default) or throw requirement_error. Dry runs always throw.
+		 */
+		void exit_on_requirement_errors(bool enabled);
+
+		/**
+		 * @brief Keeps the results of the last `capacity` distinct command lines and reuses them when one repeats.
+		 *
+		 * The key hashes the tokens, the conventions and a schema version that every registration changes. A hit skips
+		 * conventions, conversions, validators and the required and constraint checks. Its stored values are shared
+		 * with the cache rather than copied. Options with their own action run again on a hit when replay_actions is
+		 * set. Failed parses and parses that show help are not cached. With a cache each parse starts without stored
+		 * values, so a hit and a miss read the same. A hit selects the cached subcommand path again, so its factories
+		 * must register the same arguments every time they run. capacity == 0 removes the cache.
+		 */
+		void set_parse_cache(std::size_t capacity, bool replay_actions = true);
+		[[nodiscard]] parse_cache_statistics parse_cache_stats() const;
+
+		/**
+		 * @brief Makes room in the registration tables for this many more named options and positional arguments, so
+		 * registering them does not rehash. Useful before registering thousands of generated options.
+		 */
+		void reserve(std::size_t options, std::size_t positionals = 0);
+
 		template <typename T> std::optional<T> get_optional(std::string const &arg) const {
 			auto id = find_argument_id(arg);
 			if (id.has_value()) {
-				auto value = stored_arguments.find(id.value());
-				if (value != stored_arguments.end() && value->second.has_value()) {
-					return std::any_cast<T>(value->second);
+				if (auto const *value = stored_value(id.value())) {
+					return std::any_cast<T>(*value);
+				}
+				if (auto const *fallback = default_value(id.value())) {
+					return std::any_cast<T>(*fallback);
 				}
 			}
 			return std::nullopt;
 		}
 
+		/**
+		 * @brief Declares the default of a stored option as a factory.
+		 *
+		 * The factory never runs at registration or while parsing. It runs at most once, the first time the option is
+		 * read while absent, and the result is kept for later reads.
+		 */
+		void set_default_factory(std::string const &arg, std::function<std::any()> const &factory);
+
+		template <typename T> void set_default(std::string const &arg, T value) {
+			set_default_factory(arg, [value = std::move(value)] { return std::any{value}; });
+		}
+
+		/**
+		 * @brief Attaches a validator to an option parsed as T.
+		 *
+		 * Scalar options are checked right after conversion, before the action or storage sees the value. Options
+		 * added with add_appending_argument<T> are checked once per parse over the collected std::vector<T>.
+		 */
+		template <typename T> void set_validator(std::string const &arg, validators::validator<T> validator) {
+			auto id = find_argument_id(arg);
+			if (!id.has_value()) {
+				throw std::runtime_error("Cannot set a validator for unknown argument: " + arg);
+			}
+			auto &target = argument_map.at(id.value());
+			auto *typed = dynamic_cast<parametered_action<T> *>(target.action.get());
+			if (typed == nullptr) {
+				throw std::logic_error("Validator type does not match the parsed type of " + arg);
+			}
+			if (target.get_accumulation() == accumulation_mode::append) {
+				batched_validators[id.value()] = [checks = std::move(validator)](std::any &slot) {
+					auto &values = std::any_cast<std::vector<T> &>(slot);
+					auto error = checks.apply(values);
+					if (values.empty()) {
+						slot.reset();
+					}
+					return error;
+				};
+				return;
+			}
+			typed->set_validation(std::make_shared<validators::validator<T> const>(std::move(validator)));
+		}
+
+		/** @brief Hash of the registered names, storage kinds and value types, as recorded in parse images. */
+		[[nodiscard]] std::uint64_t schema_hash() const;
+		/**
+		 * @brief Serializes the stored values and invoked flags of the last parse (see parse_image.hpp). Throws
+		 * std::logic_error if a present value has a type the image cannot represent.
+		 */
+		[[nodiscard]] std::string save_image() const;
+		/**
+		 * @brief Restores a result written by save_image() in place of parsing: no tokens are read, no conversion or
+		 * action runs. Throws std::runtime_error if the image is corrupt or its schema hash differs from this parser's.
+		 */
+		void load_image(std::string_view image);
+
 		[[nodiscard]] std::string
 		build_help_text(std::initializer_list<conventions::convention const *const> convention_types) const;
 		argument &get_argument(conventions::parsed_argument const &arg);
 		[[nodiscard]] std::optional<int> find_argument_id(std::string const &arg) const;
+		/**
+		 * @brief Parses parsed_arguments. Missing required arguments and violated constraint groups print the report
+		 * with the help text and exit(1), or throw requirement_error in a dry run or after
+		 * exit_on_requirement_errors(false).
+		 */
 		void handle_arguments(std::initializer_list<conventions::convention const *const> convention_types);
+
+		/**
+		 * @brief Parses with conventions fixed at compile time, e.g. handle_arguments<static_dispatch::gnu>().
+		 *
+		 * Tokens are classified by the inlined Convention::classify of each type in order, without virtual calls or
+		 * prefix strings. Help and required-argument reports use the constant-initialized runtime_convention adapters.
+		 */
+		template <typename... Conventions> void handle_arguments() {
+			static_assert(sizeof...(Conventions) > 0, "handle_arguments<...>() needs at least one convention.");
+			handle_arguments_with({&conventions::static_dispatch::runtime_convention<Conventions>...},
+								  &base_parser::test_static_conventions<Conventions...>);
+		}
+
 		void display_help(std::initializer_list<conventions::convention const *const> convention_types) const;
 
+		/**
+		 * @brief Attaches a tracker that receives per-phase allocation counts. Pass nullptr to detach.
+		 * The tracker must outlive the parser or be detached before it is destroyed.
+		 */
+		void set_allocation_tracker(instrumentation::allocation_tracker *tracker);
+		/**
+		 * @brief Attaches a recorder that receives spans for each phase, action, conversion and on_complete handler.
+		 * Pass nullptr to detach; a detached parser pays one branch per span.
+		 */
+		void set_trace_recorder(instrumentation::trace_recorder *recorder);
+		[[nodiscard]] std::vector<instrumentation::table_footprint> footprint() const;
+
+		// registered actions capture `this`: a copy would store into the original and a moved parser's actions would
+		// point at the moved-from one, so a parser stays where it was constructed
+		base_parser(base_parser const &) = delete;
+		base_parser(base_parser &&) = delete;
+		base_parser &operator=(base_parser const &) = delete;
+		base_parser &operator=(base_parser &&) = delete;
+		~base_parser();
+
 	protected:
 		base_parser() = default;
 
@@ -306,7 +648,8 @@ namespace argument_parser {
 		std::vector<std::string> parsed_arguments;
 
 		void reset_current_conventions() {
-			_current_conventions = {};
+			std::initializer_list<conventions::convention const *const> const none;
+			_current_conventions = none;
 		}
 
 		void current_conventions(std::initializer_list<conventions::convention const *const> convention_types) {
@@ -317,107 +660,294 @@ namespace argument_parser {
 			return _current_conventions;
 		}
 
+		[[nodiscard]] instrumentation::phase_scope track_phase(instrumentation::parse_phase phase) const {
+			return {tracked_allocations, trace, phase};
+		}
+
 	private:
-		bool test_conventions(std::initializer_list<conventions::convention const *const> convention_types,
-							  std::unordered_map<std::string, std::string> &values_for_arguments,
-							  std::vector<std::pair<std::string, argument>> &found_arguments,
-							  std::optional<argument> &found_help, std::vector<std::string>::iterator &it,
-							  std::stringstream &error_stream);
-		void extract_arguments(std::initializer_list<conventions::convention const *const> convention_types,
-							   std::unordered_map<std::string, std::string> &values_for_arguments,
-							   std::vector<std::pair<std::string, argument>> &found_arguments,
-							   std::optional<argument> &found_help);
-
-		void invoke_arguments(std::unordered_map<std::string, std::string> const &values_for_arguments,
-							  std::vector<std::pair<std::string, argument>> &found_arguments,
-							  std::optional<argument> const &found_help);
+		struct found_argument {
+			std::string key;
+			argument *arg; // owned by argument_map
+			std::string value;
+			bool skipped = false; // a fail_skip validator dropped the value
+		};
+
+		// one call per token; the static path instantiates this per convention pack
+		using token_tester = bool (base_parser::*)(std::vector<found_argument> &, argument const *&,
+												   std::vector<std::string>::iterator &, internal::diagnostics &);
+
+		void handle_arguments_with(std::initializer_list<conventions::convention const *const> convention_types,
+								   token_tester test_token);
+		bool test_conventions(std::vector<found_argument> &found_arguments, argument const *&found_help,
+							  std::vector<std::string>::iterator &it, internal::diagnostics &failures);
+
+		template <typename... Conventions>
+		bool test_static_conventions(std::vector<found_argument> &found_arguments, argument const *&found_help,
+									 std::vector<std::string>::iterator &it, internal::diagnostics &failures) {
+			return (test_static_convention<Conventions>(found_arguments, found_help, it, failures) || ...);
+		}
+
+		template <typename Convention>
+		bool test_static_convention(std::vector<found_argument> &found_arguments, argument const *&found_help,
+									std::vector<std::string>::iterator &it, internal::diagnostics &failures) {
+			using code = internal::diagnostics::code;
+			auto const token_index = static_cast<std::size_t>(it - parsed_arguments.begin());
+			auto token = Convention::classify(*it);
+			if (token.type == conventions::argument_type::ERROR) {
+				failures.add(code::convention_rejected, token_index, Convention::name, token.name);
+				return false;
+			}
+
+			try {
+				conventions::parsed_argument extracted{token.type, std::string(token.name)};
+				argument *corresponding_argument = resolve_token(extracted, found_arguments, found_help);
+				if (corresponding_argument == nullptr) {
+					return true;
+				}
+
+				std::string value;
+				if (corresponding_argument->expects_parameter()) {
+					if constexpr (Convention::requires_next_token) {
+						value = next_token_value(it, extracted.second);
+					} else if (token.has_value) {
+						value.assign(token.value);
+					} else {
+						throw std::runtime_error(std::string(token.value_error));
+					}
+				}
+				found_arguments.push_back(
+					{std::move(extracted.second), corresponding_argument, std::move(value), false});
+				return true;
+			} catch (const std::runtime_error &e) {
+				failures.add(code::convention_rejected, token_index, Convention::name, std::string(e.what()));
+				return false;
+			}
+		}
+
+		[[nodiscard]] std::optional<int> find_indexed(internal::name_index const &index, std::string const &name,
+													  bool ignore_case, bool allow_prefix) const;
+		argument *resolve_token(conventions::parsed_argument const &extracted,
+								std::vector<found_argument> &found_arguments, argument const *&found_help);
+		std::string next_token_value(std::vector<std::string>::iterator &it, std::string const &name) const;
+		bool expand_counted_bundle(conventions::parsed_argument const &extracted,
+								   std::vector<found_argument> &found_arguments);
+		void extract_arguments(token_tester test_token, std::vector<found_argument> &found_arguments,
+							   argument const *&found_help);
+
+		void invoke_arguments(std::vector<found_argument> &found_arguments, argument const *found_help);
+		void invoke_arguments_concurrently(std::vector<found_argument> &found_arguments);
+		void invoke_found_argument(found_argument &found);
+		void validate_batches(std::vector<found_argument> const &found_arguments, internal::diagnostics &failures);
 		void enforce_creation_thread();
 
 		void assert_argument_not_exist(std::string const &short_arg, std::string const &long_arg) const;
 		void assert_positional_not_exist(std::string const &name) const;
-		static void set_argument_status(bool is_required, std::string const &help_text, argument &arg);
-		void place_argument(int id, argument const &arg, std::string const &short_arg, std::string const &long_arg);
-		void place_positional_argument(int id, argument const &arg, std::string const &name,
-									   std::optional<int> position);
+		void set_argument_status(bool is_required, std::string const &help_text, generated_help generated,
+								 argument &arg);
+		[[nodiscard]] std::string_view intern_option_name(std::string const &short_arg, std::string const &long_arg);
+		void place_argument(int id, argument &&arg, std::string const &short_arg, std::string const &long_arg);
+		void place_positional_argument(int id, argument &&arg, std::optional<int> position);
+		void index_argument(int id, argument &arg);
+		[[nodiscard]] std::size_t expected_occurrences(int id) const;
+		[[nodiscard]] std::any const *default_value(int id) const;
+		[[nodiscard]] std::any const *stored_value(int id) const;
 
+	protected:
+		// registration primitives behind the public add_* overloads; an empty help_text renders `generated` instead
 		template <typename ActionType>
 		void base_add_argument(std::string const &short_arg, std::string const &long_arg, std::string const &help_text,
-							   ActionType const &action, bool required) {
+							   ActionType &&action, bool required, generated_help generated = {}) {
+			auto scope = track_phase(instrumentation::parse_phase::registration);
 			assert_argument_not_exist(short_arg, long_arg);
 			int id = id_counter.fetch_add(1);
-			argument arg(id, short_arg + "|" + long_arg, action);
-			set_argument_status(required, help_text, arg);
-			place_argument(id, arg, short_arg, long_arg);
+			argument arg(id, intern_option_name(short_arg, long_arg), std::forward<ActionType>(action));
+			set_argument_status(required, help_text, generated, arg);
+			place_argument(id, std::move(arg), short_arg, long_arg);
 		}
 
 		template <typename StoreType = void>
 		void base_add_argument(std::string const &short_arg, std::string const &long_arg, std::string const &help_text,
-							   bool required) {
+							   bool required, generated_help generated = {}) {
+			auto scope = track_phase(instrumentation::parse_phase::registration);
 			assert_argument_not_exist(short_arg, long_arg);
 			int id = id_counter.fetch_add(1);
 			if constexpr (std::is_same_v<StoreType, void>) {
 				auto action =
 					helpers::make_non_parametered_action([id, this] { stored_arguments[id] = std::any{true}; });
-				argument arg(id, short_arg + "|" + long_arg, action);
-				set_argument_status(required, help_text, arg);
-				place_argument(id, arg, short_arg, long_arg);
+				argument arg(id, intern_option_name(short_arg, long_arg), std::move(action));
+				set_argument_status(required, help_text, generated, arg);
+				arg.set_storing(true);
+				place_argument(id, std::move(arg), short_arg, long_arg);
+				value_codecs[id] = image::codec_for<bool>();
 			} else {
 				auto action = helpers::make_parametered_action<StoreType>(
 					[id, this](StoreType const &value) { stored_arguments[id] = std::any{value}; });
-				argument arg(id, short_arg + "|" + long_arg, action);
-				set_argument_status(required, help_text, arg);
-				place_argument(id, arg, short_arg, long_arg);
+				argument arg(id, intern_option_name(short_arg, long_arg), std::move(action));
+				set_argument_status(required, help_text, generated, arg);
+				arg.set_storing(true);
+				place_argument(id, std::move(arg), short_arg, long_arg);
+				value_codecs[id] = image::codec_for<StoreType>();
 			}
 		}
 
+		template <typename T>
+		void base_add_appending_argument(std::string const &short_arg, std::string const &long_arg,
+										 std::string const &help_text, bool required, generated_help generated = {}) {
+			auto scope = track_phase(instrumentation::parse_phase::registration);
+			assert_argument_not_exist(short_arg, long_arg);
+			int id = id_counter.fetch_add(1);
+			auto action = helpers::make_parametered_action<T>([id, this](T const &value) {
+				auto &slot = stored_arguments[id];
+				auto *values = std::any_cast<std::vector<T>>(&slot);
+				if (values == nullptr) {
+					values = &slot.emplace<std::vector<T>>();
+					values->reserve(expected_occurrences(id));
+				}
+				values->push_back(value);
+			});
+			argument arg(id, intern_option_name(short_arg, long_arg), std::move(action));
+			set_argument_status(required, help_text, generated, arg);
+			arg.set_accumulation(accumulation_mode::append);
+			arg.set_storing(true);
+			place_argument(id, std::move(arg), short_arg, long_arg);
+			value_codecs[id] = image::codec_for<std::vector<T>>();
+		}
+
+		void base_add_counting_argument(std::string const &short_arg, std::string const &long_arg,
+										std::string const &help_text, bool required, generated_help generated = {});
+
 		template <typename ActionType>
 		void base_add_positional_argument(std::string const &name, std::string const &help_text,
-										  ActionType const &action, bool required,
-										  std::optional<int> position = std::nullopt) {
+										  ActionType &&action, bool required,
+										  std::optional<int> position = std::nullopt, generated_help generated = {}) {
+			auto scope = track_phase(instrumentation::parse_phase::registration);
 			assert_positional_not_exist(name);
 			int id = id_counter.fetch_add(1);
-			argument arg(id, name, action);
-			set_argument_status(required, help_text, arg);
+			argument arg(id, schema_strings->intern(name), std::forward<ActionType>(action));
+			set_argument_status(required, help_text, generated, arg);
 			arg.set_positional(true);
 			arg.set_position_index(position);
-			place_positional_argument(id, arg, name, position);
+			place_positional_argument(id, std::move(arg), position);
 		}
 
 		template <typename StoreType>
 		void base_add_positional_argument(std::string const &name, std::string const &help_text, bool required,
-										  std::optional<int> position = std::nullopt) {
+										  std::optional<int> position = std::nullopt, generated_help generated = {}) {
+			auto scope = track_phase(instrumentation::parse_phase::registration);
 			assert_positional_not_exist(name);
 			int id = id_counter.fetch_add(1);
 			auto action = helpers::make_parametered_action<StoreType>(
 				[id, this](StoreType const &value) { stored_arguments[id] = std::any{value}; });
-			argument arg(id, name, action);
-			set_argument_status(required, help_text, arg);
+			argument arg(id, schema_strings->intern(name), std::move(action));
+			set_argument_status(required, help_text, generated, arg);
+			arg.set_storing(true);
 			arg.set_positional(true);
 			arg.set_position_index(position);
-			place_positional_argument(id, arg, name, position);
+			place_positional_argument(id, std::move(arg), position);
+			value_codecs[id] = image::codec_for<StoreType>();
 		}
 
-		void check_for_required_arguments(std::initializer_list<conventions::convention const *const> convention_types);
-		void fire_on_complete_events() const;
+	private:
+		[[nodiscard]] std::string image_key(int id) const;
+		void check_for_required_arguments(std::initializer_list<conventions::convention const *const> convention_types,
+										  std::vector<found_argument> const &found_arguments,
+										  argument const *found_help);
+		[[nodiscard]] std::size_t constraint_index(std::string const &arg) const;
+		[[nodiscard]] std::vector<std::size_t> constraint_indices(std::vector<std::string> const &names) const;
+		[[nodiscard]] std::string describe_argument(std::size_t index) const;
+		[[nodiscard]] std::string describe_constraint(std::size_t constraint) const;
+		[[nodiscard]] std::uint64_t parse_cache_key(
+			std::initializer_list<conventions::convention const *const> convention_types) const;
+		[[nodiscard]] bool restore_cached_parse(std::shared_ptr<internal::parse_cache::result const> cached);
+		void remember_parse(std::uint64_t key, std::vector<found_argument> const &found_arguments);
+		void fire_on_complete_events();
+		void join_async_on_complete_events() const noexcept;
+		bool try_select_subcommand(std::string const &token);
+		void rollback_subcommands();
+
+		struct subcommand_entry {
+			std::string name;
+			std::string help_text;
+			std::function<void(base_parser &)> factory;
+		};
+		static bool subcommand_less(subcommand_entry const &entry, std::string const &name);
+
+		// the schema as it was before a subcommand factory ran, and the level the subcommand was selected from
+		struct subcommand_mark {
+			std::size_t arguments; // argument_order.size()
+			std::vector<int> positional_arguments;
+			std::size_t constraints;
+			std::size_t on_complete_events;
+			std::size_t async_on_complete_events;
+			std::uint64_t schema_version;
+			std::vector<subcommand_entry> subcommands;
+		};
+		[[nodiscard]] subcommand_mark mark_schema() const;
+		// removes everything registered since mark was taken, except subcommands
+		void rollback_schema(subcommand_mark &mark);
 
 		inline static std::atomic_int id_counter = 0;
 
 		std::unordered_map<int, std::any> stored_arguments;
+		std::unordered_map<int, std::size_t> occurrence_counts;
+		std::unordered_map<int, std::function<std::any()>> default_factories;
+		std::unordered_map<int, std::function<std::string(std::any &)>> batched_validators;
+		std::unordered_map<int, image::value_codec> value_codecs; // storing options only
+		mutable std::unordered_map<int, std::any> materialized_defaults;
 		std::unordered_map<int, argument> argument_map;
-		std::unordered_map<std::string, int> short_arguments;
-		std::unordered_map<int, std::string> reverse_short_arguments;
-		std::unordered_map<std::string, int> long_arguments;
-		std::unordered_map<int, std::string> reverse_long_arguments;
+		// every name below is a view into schema_strings, shared with argument::name
+		std::shared_ptr<internal::string_pool> schema_strings = std::make_shared<internal::string_pool>();
+		std::unordered_map<std::string_view, int> short_arguments;
+		std::unordered_map<int, std::string_view> reverse_short_arguments;
+		std::unordered_map<std::string_view, int> long_arguments;
+		std::unordered_map<int, std::string_view> reverse_long_arguments;
+		// folded views of the two name tables, rebuilt on the first lookup after a registration
+		internal::name_index long_index;
+		internal::name_index short_index;
+		bool names_indexed = false;
+		name_matching long_matching;
 
 		std::vector<int> positional_arguments;
-		std::unordered_map<std::string, int> positional_name_map;
-		std::unordered_map<int, std::string> reverse_positional_names;
+		std::unordered_map<std::string_view, int> positional_name_map;
+		std::unordered_map<int, std::string_view> reverse_positional_names;
+
+		std::vector<int> argument_order; // argument::index -> id
+		internal::constraint_set constraints;
+		internal::option_bits seen_arguments; // of the last parse, reused between parses
+
+		std::optional<internal::parse_cache> result_cache;
+		bool replay_cached_actions = true;
+		std::uint64_t schema_version = 0;
+		// the values of the last parse when it was a cache hit; read after stored_arguments
+		std::shared_ptr<internal::parse_cache::result const> restored_result;
 
 		std::initializer_list<conventions::convention const *const> _current_conventions;
 		internal::atomic::copyable_atomic<std::thread::id> creation_thread_id = std::this_thread::get_id();
 
 		std::list<std::function<void(base_parser const &)>> on_complete_events;
 
+		struct async_on_complete_event {
+			std::string name;
+			std::function<void(base_parser const &)> handler;
+			std::vector<std::size_t> after;
+			std::shared_future<void> done;
+		};
+		std::vector<async_on_complete_event> async_on_complete_events;
+		// on the heap so the parser stays movable; guards materialized_defaults against concurrent handlers
+		std::shared_ptr<std::mutex> defaults_mutex = std::make_shared<std::mutex>();
+
+		std::vector<subcommand_entry> subcommands; // of the level being parsed, sorted by name
+		std::vector<std::string> selected_subcommands;
+		std::vector<subcommand_mark> subcommand_marks; // one per selected subcommand
+
+		std::unordered_map<int, std::vector<std::string>> action_dependencies;
+		bool concurrent_actions = false;
+		bool dry_run = false;
+		bool exit_on_requirement_error = true;
+		unsigned concurrent_action_threads = 0;
+		instrumentation::allocation_tracker *tracked_allocations = nullptr;
+		instrumentation::trace_recorder *trace = nullptr;
+
 		friend class linux_parser;
 		friend class windows_parser;
 		friend class macos_parser;
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_CONSTRAINTS_HPP
+#define ARGUMENT_PARSER_CONSTRAINTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace argument_parser::internal {
+	/** @brief A set of dense option indices; index i is bit i % 64 of word i / 64. */
+	class option_bits {
+	public:
+		void set(std::size_t index);
+		/** @brief Clears every bit and keeps the capacity. */
+		void clear() noexcept;
+		[[nodiscard]] bool test(std::size_t index) const noexcept;
+		[[nodiscard]] std::uint64_t word(std::size_t word_index) const noexcept;
+		[[nodiscard]] std::size_t word_count() const noexcept;
+
+	private:
+		std::vector<std::uint64_t> words;
+	};
+
+	/**
+	 * @brief Presence constraints between options, compiled to bitmasks over dense option indices.
+	 *
+	 * A constraint keeps only the nonzero words of its mask, so checking it against the options seen in a parse costs
+	 * a few word operations per 64 indices it spans. Nothing is formatted here: check() and missing_required() report
+	 * indices, and the parser renders messages only when something failed.
+	 */
+	class constraint_set {
+	public:
+		enum class kind : std::uint8_t {
+			mutually_exclusive, // at most one member seen
+			at_least_one,		// some member seen
+			requires_all		// subject seen implies every member seen
+		};
+
+		void require(std::size_t index);
+		void add_group(kind type, std::vector<std::size_t> const &members);
+		void add_requirement(std::size_t subject, std::vector<std::size_t> const &members);
+		/** @brief Keeps the first constraint_count constraints and the requirements of indices below `indices`. */
+		void truncate(std::size_t constraint_count, std::size_t indices);
+
+		/** @brief Appends the indices of required options that were not seen, in index order. */
+		void missing_required(option_bits const &seen, std::vector<std::size_t> &missing) const;
+		/** @brief Appends the numbers of the violated constraints, in the order they were added. */
+		void check(option_bits const &seen, std::vector<std::size_t> &violated) const;
+
+		[[nodiscard]] kind type_of(std::size_t constraint) const;
+		[[nodiscard]] std::size_t subject_of(std::size_t constraint) const; // requires_all only
+		[[nodiscard]] std::vector<std::size_t> members_of(std::size_t constraint) const;
+
+		[[nodiscard]] std::size_t size() const noexcept;
+		[[nodiscard]] std::size_t bytes() const noexcept;
+
+	private:
+		struct term {
+			std::uint32_t word;
+			std::uint64_t bits;
+		};
+
+		struct constraint {
+			kind type;
+			std::size_t subject;
+			std::uint32_t first_term;
+			std::uint32_t last_term;
+		};
+
+		void add(kind type, std::size_t subject, std::vector<std::size_t> const &members);
+
+		std::vector<std::uint64_t> required;
+		std::vector<constraint> constraints;
+		std::vector<term> terms; // the masks of every constraint, back to back, sorted by word within each
+	};
+} // namespace argument_parser::internal
+
+#endif // ARGUMENT_PARSER_CONSTRAINTS_HPP
@@ -0,0 +1,55 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_DIAGNOSTICS_HPP
+#define ARGUMENT_PARSER_DIAGNOSTICS_HPP
+
+#include <base_convention.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argument_parser::internal {
+	/**
+	 * @brief Parse failures recorded as a code and the index of the token or found argument they concern.
+	 *
+	 * Recording formats nothing: the text of an entry is a view of static text, such as a convention's reason for
+	 * rejecting a token, or the string the failure already produced. render() builds the readable report, so messages
+	 * are only paid for once a parse has actually failed.
+	 */
+	class diagnostics {
+	public:
+		enum class code : std::uint8_t {
+			convention_rejected, // a convention could not take the token; subject is the convention
+			action_failed,		 // an action, conversion or validator failed; ${KEY} in the text names the argument
+			dependency_failed	 // skipped because an action it depends on failed
+		};
+
+		/** @brief subject and text are views that must outlive render(). */
+		void add(code what, std::size_t index, std::string_view subject, std::string_view text);
+		void add(code what, std::size_t index, std::string_view subject, std::string text);
+		/** @brief For runtime conventions, whose name is only asked for when rendering. */
+		void add(code what, std::size_t index, conventions::convention const &convention, std::string text);
+		void append(diagnostics &&other);
+
+		/** @brief Drops every entry and keeps the capacity. */
+		void clear() noexcept;
+		[[nodiscard]] bool empty() const noexcept;
+		/** @brief One line per entry, in the order they were added. */
+		[[nodiscard]] std::string render() const;
+
+	private:
+		struct entry {
+			code what;
+			std::size_t index; // into the parsed tokens, or into the found arguments for action entries
+			conventions::convention const *convention;
+			std::string_view subject;
+			std::string_view text; // used when owned_text is empty
+			std::string owned_text;
+		};
+
+		std::vector<entry> entries;
+	};
+} // namespace argument_parser::internal
+
+#endif // ARGUMENT_PARSER_DIAGNOSTICS_HPP
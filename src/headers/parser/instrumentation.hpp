@@ -0,0 +1,189 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_INSTRUMENTATION_HPP
+#define ARGUMENT_PARSER_INSTRUMENTATION_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argument_parser::instrumentation {
+	enum class parse_phase : unsigned {
+		registration,
+		extract_arguments,
+		invoke_arguments,
+		check_for_required_arguments,
+		fire_on_complete_events
+	};
+
+	constexpr std::size_t phase_count = static_cast<std::size_t>(parse_phase::fire_on_complete_events) + 1;
+
+	const char *phase_name(parse_phase phase) noexcept;
+
+	struct allocation_counter {
+		std::size_t allocations = 0;
+		std::size_t bytes = 0;
+	};
+
+	/**
+	 * @brief Per-phase allocation counts for a parser.
+	 *
+	 * Counting only happens while the parser is inside one of its phases and the allocation goes through the global
+	 * operator new replacement in the argument_parser::allocation_interposition target, which the executable links to
+	 * opt in. Recording never allocates.
+	 */
+	class allocation_tracker {
+	public:
+		void record(parse_phase phase, std::size_t bytes) noexcept;
+		[[nodiscard]] allocation_counter const &at(parse_phase phase) const noexcept;
+		[[nodiscard]] allocation_counter total() const noexcept;
+		void reset() noexcept;
+		[[nodiscard]] std::string report() const;
+
+	private:
+		std::array<allocation_counter, phase_count> counters{};
+	};
+
+	struct table_footprint {
+		const char *table;
+		std::size_t entries;
+		std::size_t bytes;
+	};
+
+	struct trace_event {
+		std::string name;
+		const char *category;
+		std::uint64_t start_ns;
+		std::uint64_t duration_ns;
+		std::uint32_t thread;
+	};
+
+	/**
+	 * @brief Collects timestamped spans for parser phases, action invocations, parser_trait conversions and
+	 * on_complete handlers. Export with to_chrome_trace() (load in chrome://tracing or Perfetto) or summary().
+	 * Recording is thread-safe so spans from concurrently invoked actions land in the same trace.
+	 */
+	class trace_recorder {
+	public:
+		using clock = std::chrono::steady_clock;
+
+		trace_recorder();
+
+		void record(std::string_view name, const char *category, clock::time_point start, clock::time_point end);
+		/** @brief A copy of the spans recorded so far, taken under the lock so recording threads may keep going. */
+		[[nodiscard]] std::vector<trace_event> events() const;
+		void clear() noexcept;
+		[[nodiscard]] std::string to_chrome_trace() const;
+		[[nodiscard]] std::string summary() const;
+
+	private:
+		clock::time_point epoch;
+		std::vector<trace_event> recorded;
+		mutable std::mutex recorded_mutex;
+	};
+
+	namespace detail {
+		inline thread_local allocation_tracker *active_tracker = nullptr;
+		inline thread_local trace_recorder *active_recorder = nullptr;
+		inline thread_local parse_phase active_phase = parse_phase::registration;
+		inline thread_local std::string_view active_option{};
+
+		inline void record_allocation(std::size_t bytes) noexcept {
+			if (active_tracker != nullptr) {
+				active_tracker->record(active_phase, bytes);
+			}
+		}
+	} // namespace detail
+
+	/**
+	 * @brief Times the enclosing block into the active trace_recorder, if any. Without a recorder this is a single
+	 * branch on construction and one on destruction. The name must outlive the span.
+	 */
+	class trace_span {
+	public:
+		trace_span(const char *category, std::string_view name) noexcept
+			: recorder(detail::active_recorder), category(category), name(name) {
+			if (recorder != nullptr) {
+				start = trace_recorder::clock::now();
+			}
+		}
+
+		~trace_span() {
+			if (recorder != nullptr) {
+				recorder->record(name, category, start, trace_recorder::clock::now());
+			}
+		}
+
+		trace_span(trace_span const &) = delete;
+		trace_span &operator=(trace_span const &) = delete;
+
+	private:
+		trace_recorder *recorder;
+		const char *category;
+		std::string_view name;
+		trace_recorder::clock::time_point start{};
+	};
+
+	/**
+	 * @brief Names the parser_trait conversion spans recorded in the enclosing block after the option they belong to.
+	 */
+	class option_scope {
+	public:
+		explicit option_scope(std::string_view option) noexcept : previous(detail::active_option) {
+			detail::active_option = option;
+		}
+
+		~option_scope() {
+			detail::active_option = previous;
+		}
+
+		option_scope(option_scope const &) = delete;
+		option_scope &operator=(option_scope const &) = delete;
+
+	private:
+		std::string_view previous;
+	};
+
+	class phase_scope {
+	public:
+		phase_scope(allocation_tracker *tracker, trace_recorder *recorder, parse_phase phase) noexcept
+			: previous_tracker(detail::active_tracker), previous_recorder(detail::active_recorder),
+			  previous_phase(detail::active_phase) {
+			// installed even when null, so a parser run from another parser's action is not billed to the outer one
+			detail::active_tracker = tracker;
+			detail::active_recorder = recorder;
+			detail::active_phase = phase;
+			// nested registrations (v2 -> v1) are reported once, by the outermost scope
+			timed = recorder != nullptr && !(previous_recorder == recorder && previous_phase == phase);
+			if (timed) {
+				start = trace_recorder::clock::now();
+			}
+		}
+
+		~phase_scope() {
+			if (timed) {
+				detail::active_recorder->record(phase_name(detail::active_phase), "phase", start,
+												trace_recorder::clock::now());
+			}
+			detail::active_tracker = previous_tracker;
+			detail::active_recorder = previous_recorder;
+			detail::active_phase = previous_phase;
+		}
+
+		phase_scope(phase_scope const &) = delete;
+		phase_scope &operator=(phase_scope const &) = delete;
+
+	private:
+		allocation_tracker *previous_tracker;
+		trace_recorder *previous_recorder;
+		parse_phase previous_phase;
+		bool timed = false;
+		trace_recorder::clock::time_point start{};
+	};
+} // namespace argument_parser::instrumentation
+
+#endif // ARGUMENT_PARSER_INSTRUMENTATION_HPP
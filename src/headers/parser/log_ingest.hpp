@@ -0,0 +1,125 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_LOG_INGEST_HPP
+#define ARGUMENT_PARSER_LOG_INGEST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <ostream>
+#include <parser_v2.hpp>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <validators.hpp>
+#include <variant>
+#include <vector>
+
+/**
+ * Offline parsing of recorded command lines.
+ *
+ * A log holds one command line per record, where records are separated by '\n' or by NUL. Each record is split on
+ * spaces and tabs, and its first token is the program name. Records are parsed in parallel chunks with the real
+ * option registrations, in dry-run mode (see base_parser::set_dry_run). One output row is written per record, in
+ * log order: one column per selected option, then an "error" column.
+ *
+ * CSV output has a header row. Absent values and successful parses leave empty cells.
+ *
+ * Binary output is columnar, in host byte order:
+ *   "APCOLS01" | u32 column count | per column: u8 column_kind, u32 name length, name bytes
+ *   then row groups until EOF, each: u64 rows | per column: rows validity bytes (0/1), then the values of every row
+ *   (i64 / f64 / u8 for integer / real / boolean; text: u32 length per row, then the bytes of every row)
+ * Absent values keep their slot with validity 0. The error column is a text column and always the last one.
+ */
+namespace argument_parser::ingest {
+	enum class record_format { newline_delimited, nul_delimited };
+	enum class output_format { csv, binary };
+	enum class column_kind : std::uint8_t { integer, real, boolean, text };
+
+	using cell = std::variant<std::monostate, std::int64_t, double, bool, std::string>;
+
+	/** @brief The options records are parsed against, and which of them become output columns. */
+	class schema {
+	public:
+		explicit schema(std::function<void(v2::base_parser &)> options);
+
+		/** @brief Adds an output column holding the value of option, read with get_optional<T>. */
+		template <typename T> schema &column(std::string const &option) {
+			columns.push_back({option, kind_of<T>(), [option](v2::base_parser &parser) -> cell {
+								   auto value = parser.get_optional<T>(option);
+								   if (!value.has_value()) {
+									   return std::monostate{};
+								   }
+								   return to_cell(value.value());
+							   }});
+			return *this;
+		}
+
+		struct column_definition {
+			std::string name;
+			column_kind kind;
+			std::function<cell(v2::base_parser &)> read;
+		};
+
+		[[nodiscard]] std::vector<column_definition> const &output_columns() const;
+		void register_options(v2::base_parser &parser) const;
+
+	private:
+		template <typename T> static constexpr column_kind kind_of() {
+			if constexpr (std::is_same_v<T, bool>) {
+				return column_kind::boolean;
+			} else if constexpr (std::is_integral_v<T>) {
+				return column_kind::integer;
+			} else if constexpr (std::is_floating_point_v<T>) {
+				return column_kind::real;
+			} else {
+				return column_kind::text;
+			}
+		}
+
+		template <typename T> static cell to_cell(T const &value) {
+			if constexpr (std::is_same_v<T, bool>) {
+				return value;
+			} else if constexpr (std::is_integral_v<T>) {
+				return static_cast<std::int64_t>(value);
+			} else if constexpr (std::is_floating_point_v<T>) {
+				return static_cast<double>(value);
+			} else if constexpr (std::is_convertible_v<T, std::string>) {
+				return std::string(value);
+			} else {
+				return validators::detail::describe(value);
+			}
+		}
+
+		std::function<void(v2::base_parser &)> options;
+		std::vector<column_definition> columns;
+	};
+
+	struct settings {
+		record_format records = record_format::newline_delimited;
+		output_format output = output_format::csv;
+		unsigned max_threads = 0;			 // 0 uses the hardware concurrency
+		std::size_t chunk_bytes = 1u << 20; // parallel chunk size in log bytes, rounded up to a record boundary
+	};
+
+	struct summary {
+		std::size_t records = 0;
+		std::size_t errors = 0;
+	};
+
+	/**
+	 * @brief Parses every record of data and writes the table to output. Failures of single records become rows with
+	 * an error; anything else a worker or the output throws stops the pool and is rethrown once it has joined.
+	 */
+	summary ingest(std::string_view data, std::ostream &output, schema const &options,
+				   std::initializer_list<conventions::convention const *const> convention_types,
+				   settings const &config = {});
+
+	/** @brief Maps the file read-only and ingests it. Throws std::runtime_error if it cannot be opened. */
+	summary ingest_file(std::string const &path, std::ostream &output, schema const &options,
+						std::initializer_list<conventions::convention const *const> convention_types,
+						settings const &config = {});
+} // namespace argument_parser::ingest
+
+#endif // ARGUMENT_PARSER_LOG_INGEST_HPP
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_NAME_INDEX_HPP
+#define ARGUMENT_PARSER_NAME_INDEX_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace argument_parser::internal {
+	/** @brief Three-way comparison of ASCII case-folded bytes; nothing is copied. */
+	int fold_compare(std::string_view lhs, std::string_view rhs) noexcept;
+	bool fold_equal(std::string_view lhs, std::string_view rhs) noexcept;
+
+	/**
+	 * @brief Option names sorted by their case-folded spelling (exact spelling breaks ties).
+	 *
+	 * Built once per registration change, then queried with binary searches only: exact, case-insensitive and
+	 * unique-prefix lookups are O(log n + matches) and never allocate.
+	 */
+	class name_index {
+	public:
+		struct entry {
+			std::string_view name; // owned by the parser's string pool
+			int id;
+		};
+
+		enum class match_status { none, unique, ambiguous };
+
+		struct match {
+			match_status status = match_status::none;
+			int id = -1;
+			// candidates to report when ambiguous; filter them with matches_query()
+			entry const *first = nullptr;
+			entry const *last = nullptr;
+		};
+
+		void rebuild(std::unordered_map<std::string_view, int> const &names);
+		[[nodiscard]] match find(std::string_view query, bool ignore_case, bool allow_prefix) const;
+		[[nodiscard]] static bool matches_query(entry const &candidate, std::string_view query, bool ignore_case,
+												bool allow_prefix) noexcept;
+		[[nodiscard]] std::size_t size() const noexcept;
+		[[nodiscard]] std::size_t bytes() const noexcept;
+
+	private:
+		[[nodiscard]] match resolve(entry const *first, entry const *last, std::string_view query, bool ignore_case,
+									bool allow_prefix) const noexcept;
+
+		std::vector<entry> entries;
+	};
+} // namespace argument_parser::internal
+
+#endif // ARGUMENT_PARSER_NAME_INDEX_HPP
@@ -0,0 +1,76 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_PARSE_CACHE_HPP
+#define ARGUMENT_PARSER_PARSE_CACHE_HPP
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace argument_parser {
+	struct parse_cache_statistics {
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		std::uint64_t evictions = 0;
+		std::size_t entries = 0;
+	};
+} // namespace argument_parser
+
+namespace argument_parser::internal {
+	/**
+	 * @brief Bounded LRU map from a command line to the result of parsing it.
+	 *
+	 * Results are immutable and shared: a hit hands out the same result object the miss stored, so nothing is copied.
+	 * The key is a hash; find() also compares the tokens, so a hash collision is a miss rather than a wrong result.
+	 */
+	class parse_cache {
+	public:
+		// arguments are kept by their dense index rather than their id: a subcommand factory that runs again on a hit
+		// registers new ids, but at the same indices
+		struct replayed_action {
+			std::size_t index;
+			std::string key;
+			std::string value;
+		};
+
+		struct result {
+			std::vector<std::string> tokens;
+			std::vector<std::string> subcommand_path; // selected again on a hit, before anything is restored
+			std::uint64_t schema_version = 0;		  // after the selection; a hit registering differently is a miss
+			std::vector<std::pair<std::size_t, std::any>> values; // sorted by index
+			std::vector<std::size_t> invoked;
+			std::vector<replayed_action> actions; // options with their own action, in command-line order
+		};
+
+		explicit parse_cache(std::size_t capacity);
+		parse_cache(parse_cache const &other);
+		parse_cache &operator=(parse_cache const &other);
+		parse_cache(parse_cache &&other) noexcept = default;
+		parse_cache &operator=(parse_cache &&other) noexcept = default;
+
+		[[nodiscard]] static std::uint64_t key_of(std::vector<std::string> const &tokens, std::uint64_t salt) noexcept;
+
+		[[nodiscard]] std::shared_ptr<result const> find(std::uint64_t key, std::vector<std::string> const &tokens);
+		void insert(std::uint64_t key, std::shared_ptr<result const> value);
+
+		[[nodiscard]] parse_cache_statistics statistics() const noexcept;
+		[[nodiscard]] std::size_t bytes() const noexcept;
+
+	private:
+		using entry = std::pair<std::uint64_t, std::shared_ptr<result const>>;
+
+		void rebuild_index();
+
+		std::size_t capacity;
+		std::list<entry> recent; // most recently used first
+		std::unordered_map<std::uint64_t, std::list<entry>::iterator> index;
+		parse_cache_statistics counters;
+	};
+} // namespace argument_parser::internal
+
+#endif // ARGUMENT_PARSER_PARSE_CACHE_HPP
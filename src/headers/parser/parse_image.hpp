@@ -0,0 +1,168 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_PARSE_IMAGE_HPP
+#define ARGUMENT_PARSER_PARSE_IMAGE_HPP
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * A parse result as a flat, position-independent byte image, written by base_parser::save_image() and read back by
+ * base_parser::load_image() in another process that made the same registrations.
+ *
+ * Layout (host byte order, every offset from the start of the image):
+ *   header: "APIMG001" | u64 schema hash | u32 entry count | u32 reserved | u64 image size
+ *   entries: per option, u32 key offset | u32 key length | u32 value offset | u32 value length | u32 flags
+ *   then the key and value bytes.
+ * Values are stored as their object bytes for arithmetic and enum types, so loading never runs a conversion. Strings
+ * and vectors of either are supported as well; options of any other type are recorded as invoked only, without a
+ * value.
+ */
+namespace argument_parser::image {
+	/** @brief How a stored option type is written to and read from an image. */
+	struct value_codec {
+		char const *type_name = nullptr;								  // part of the schema hash
+		void (*encode)(std::any const &value, std::string &out) = nullptr; // nullptr: not representable
+		std::any (*decode)(std::string_view bytes) = nullptr;
+	};
+
+	namespace detail {
+		template <typename T> struct is_vector : std::false_type {};
+		template <typename T, typename A> struct is_vector<std::vector<T, A>> : std::true_type {};
+
+		// only types whose bytes mean the same in another process: no pointers, not even inside a struct
+		template <typename T> constexpr bool is_raw = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+		template <typename T> T read_raw(std::string_view bytes) {
+			if (bytes.size() != sizeof(T)) {
+				throw std::runtime_error("Corrupt parse image: value size mismatch");
+			}
+			T value;
+			std::memcpy(&value, bytes.data(), sizeof(T));
+			return value;
+		}
+
+		void append_u32(std::string &out, std::uint32_t value);
+		std::uint32_t read_u32(std::string_view bytes, std::size_t offset);
+
+		template <typename T> void encode(std::any const &value, std::string &out) {
+			auto const &typed = std::any_cast<T const &>(value);
+			if constexpr (std::is_same_v<T, std::string>) {
+				out.append(typed);
+			} else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+				append_u32(out, static_cast<std::uint32_t>(typed.size()));
+				for (auto const &item : typed) {
+					append_u32(out, static_cast<std::uint32_t>(item.size()));
+				}
+				for (auto const &item : typed) {
+					out.append(item);
+				}
+			} else if constexpr (is_vector<T>::value) {
+				out.append(reinterpret_cast<char const *>(typed.data()), typed.size() * sizeof(typename T::value_type));
+			} else {
+				out.append(reinterpret_cast<char const *>(&typed), sizeof(T));
+			}
+		}
+
+		template <typename T> std::any decode(std::string_view bytes) {
+			if constexpr (std::is_same_v<T, std::string>) {
+				return std::string(bytes);
+			} else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+				std::uint32_t count = read_u32(bytes, 0);
+				std::size_t data = 4 + std::size_t{count} * 4;
+				if (data > bytes.size()) {
+					throw std::runtime_error("Corrupt parse image: string list out of bounds");
+				}
+				std::vector<std::string> values;
+				values.reserve(count);
+				for (std::uint32_t i = 0; i < count; ++i) {
+					auto length = read_u32(bytes, 4 + std::size_t{i} * 4);
+					if (length > bytes.size() - data) {
+						throw std::runtime_error("Corrupt parse image: string list out of bounds");
+					}
+					values.emplace_back(bytes.substr(data, length));
+					data += length;
+				}
+				return values;
+			} else if constexpr (is_vector<T>::value) {
+				using element = typename T::value_type;
+				if (bytes.size() % sizeof(element) != 0) {
+					throw std::runtime_error("Corrupt parse image: value size mismatch");
+				}
+				T values(bytes.size() / sizeof(element));
+				std::memcpy(values.data(), bytes.data(), bytes.size());
+				return values;
+			} else {
+				return read_raw<T>(bytes);
+			}
+		}
+
+		template <typename T> constexpr bool representable() {
+			if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::vector<std::string>>) {
+				return true;
+			} else if constexpr (is_vector<T>::value) {
+				return is_raw<typename T::value_type> && !std::is_same_v<typename T::value_type, bool>;
+			} else {
+				return is_raw<T>;
+			}
+		}
+	} // namespace detail
+
+	template <typename T> value_codec codec_for() {
+		if constexpr (detail::representable<T>()) {
+			return {typeid(T).name(), &detail::encode<T>, &detail::decode<T>};
+		} else {
+			return {typeid(T).name(), nullptr, nullptr};
+		}
+	}
+
+	struct entry {
+		std::string key;
+		bool invoked = false;
+		bool has_value = false;
+		std::string value;
+	};
+
+	struct entry_view {
+		std::string_view key;
+		bool invoked = false;
+		bool has_value = false;
+		std::string_view value;
+	};
+
+	[[nodiscard]] std::string write(std::uint64_t schema_hash, std::vector<entry> const &entries);
+	/** @brief Validates bounds and the schema hash; throws std::runtime_error on any mismatch. */
+	[[nodiscard]] std::vector<entry_view> read(std::string_view image, std::uint64_t expected_schema_hash);
+
+	/** @brief A read-only mapping of a whole file descriptor (memfd, shared memory object, inherited file). */
+	class mapped_image {
+	public:
+		explicit mapped_image(int fd);
+		mapped_image(mapped_image const &) = delete;
+		mapped_image &operator=(mapped_image const &) = delete;
+		mapped_image(mapped_image &&other) noexcept;
+		mapped_image &operator=(mapped_image &&other) noexcept;
+		~mapped_image();
+
+		[[nodiscard]] std::string_view bytes() const;
+
+	private:
+		void const *data = nullptr;
+		std::size_t size = 0;
+	};
+
+	/**
+	 * @brief Writes image to a new sealed memfd and returns its descriptor, to be inherited by exec'd workers.
+	 * Linux only; throws std::runtime_error elsewhere or on failure.
+	 */
+	int to_memfd(std::string_view image, char const *name = "argparse-image");
+} // namespace argument_parser::image
+
+#endif // ARGUMENT_PARSER_PARSE_IMAGE_HPP
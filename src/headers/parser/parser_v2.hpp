@@ -2,6 +2,7 @@
 #include "traits.hpp"
 #include <argument_parser.hpp>
 #include <array>
+#include <cstdint>
 #include <cstdlib>
 #include <initializer_list>
 #include <memory>
@@ -23,7 +24,72 @@ namespace argument_parser::v2 {
 		HelpText,
 		Action,
 		Required,
-		Reference
+		Reference,
+		Append,
+		Count
+	};
+
+	/** @brief The bit of flag in a mask of add_argument_flags. */
+	constexpr std::uint32_t flag_bit(add_argument_flags flag) {
+		return 1u << static_cast<unsigned>(flag);
+	}
+
+	/**
+	 * @brief An action handed to add_argument. Actions are move-only, so a slot is a one-shot handle: copying it, as
+	 * building a map from a pair list does, hands the action over, and registration moves it out even from a const
+	 * list or map. Either way the action itself is never copied, and a slot registers at most once.
+	 */
+	template <typename Action> class action_slot {
+	public:
+		action_slot(Action action) : action(std::move(action)) {} // NOLINT(google-explicit-constructor)
+		action_slot(action_slot const &other) : action(other.take()) {}
+		action_slot(action_slot &&other) noexcept = default;
+		action_slot &operator=(action_slot const &other) {
+			action = other.take();
+			return *this;
+		}
+		action_slot &operator=(action_slot &&other) noexcept = default;
+		~action_slot() = default;
+
+		[[nodiscard]] Action take() const {
+			return std::move(action);
+		}
+
+	private:
+		mutable Action action;
+	};
+
+	/** @brief The given pairs indexed by flag, pointing into the caller's list or map; nothing is copied. */
+	template <typename Value> class flag_slots {
+	public:
+		void set(add_argument_flags flag, Value const &value) { // a repeated flag keeps its last value
+			slots[static_cast<std::size_t>(flag)] = &value;
+			present |= flag_bit(flag);
+		}
+
+		template <typename T> T const *get(add_argument_flags flag, char const *key) const {
+			Value const *value = slots[static_cast<std::size_t>(flag)];
+			if (value == nullptr) {
+				return nullptr;
+			}
+			if (auto const *typed = std::get_if<T>(value)) {
+				return typed;
+			}
+			throw std::invalid_argument(std::string("variant type mismatch for key: ") + key);
+		}
+
+		[[nodiscard]] bool enabled(add_argument_flags flag, char const *key) const {
+			auto const *value = get<bool>(flag, key);
+			return value != nullptr && *value;
+		}
+
+		[[nodiscard]] std::uint32_t mask() const {
+			return present;
+		}
+
+	private:
+		std::array<Value const *, static_cast<std::size_t>(add_argument_flags::Count) + 1> slots{};
+		std::uint32_t present = 0;
 	};
 
 	namespace flags {
@@ -35,43 +101,52 @@ namespace argument_parser::v2 {
 		constexpr static inline add_argument_flags Positional = add_argument_flags::Positional;
 		constexpr static inline add_argument_flags Position = add_argument_flags::Position;
 		constexpr static inline add_argument_flags Reference = add_argument_flags::Reference;
+		constexpr static inline add_argument_flags Append = add_argument_flags::Append;
+		constexpr static inline add_argument_flags Count = add_argument_flags::Count;
 	} // namespace flags
 
 	class base_parser : private argument_parser::base_parser {
 	public:
-		template <typename T> using typed_flag_value = std::variant<std::string, parametered_action<T>, bool, int, T *>;
-		using non_typed_flag_value = std::variant<std::string, non_parametered_action, bool, int>;
+		template <typename T>
+		using typed_flag_value = std::variant<std::string, action_slot<parametered_action<T>>, bool, int, T *>;
+		using non_typed_flag_value = std::variant<std::string, action_slot<non_parametered_action>, bool, int>;
 
 		template <typename T> using typed_argument_pair = std::pair<add_argument_flags, typed_flag_value<T>>;
 		using non_typed_argument_pair = std::pair<add_argument_flags, non_typed_flag_value>;
 
 		template <typename T>
 		void add_argument(std::unordered_map<add_argument_flags, typed_flag_value<T>> const &argument_pairs) {
-			add_argument_impl<true, parametered_action<T>, T>(argument_pairs);
+			add_argument_impl<true, parametered_action<T>, T>(collect_flags(argument_pairs));
 		}
 
 		template <typename T> void add_argument(std::initializer_list<typed_argument_pair<T>> const &pairs) {
-			std::unordered_map<add_argument_flags, typed_flag_value<T>> args;
-
-			for (auto &[k, v] : pairs) {
-				args[k] = v;
-			}
-
-			add_argument<T>(args);
+			add_argument_impl<true, parametered_action<T>, T>(collect_flags(pairs));
 		}
 
 		void add_argument(std::initializer_list<non_typed_argument_pair> const &pairs) {
-			std::unordered_map<add_argument_flags, non_typed_flag_value> args;
+			add_argument_impl<false, non_parametered_action, void>(collect_flags(pairs));
+		}
 
-			for (auto &[k, v] : pairs) {
-				args[k] = v;
-			}
+		void add_argument(std::unordered_map<add_argument_flags, non_typed_flag_value> const &argument_pairs) {
+			add_argument_impl<false, non_parametered_action, void>(collect_flags(argument_pairs));
+		}
 
-			add_argument(args);
+		/** @brief Registers from values already indexed by flag, as the argument builder does. */
+		template <typename T> void add_argument(flag_slots<typed_flag_value<T>> &&slots) {
+			add_argument_impl<true, parametered_action<T>, T>(std::move(slots));
 		}
 
-		void add_argument(std::unordered_map<add_argument_flags, non_typed_flag_value> const &argument_pairs) {
-			add_argument_impl<false, non_parametered_action, void>(argument_pairs);
+		void add_argument(flag_slots<non_typed_flag_value> &&slots) {
+			add_argument_impl<false, non_parametered_action, void>(std::move(slots));
+		}
+
+		/**
+		 * @brief Registers a lazily materialized subcommand. The factory receives this parser once the subcommand is
+		 * selected by the first positional token; see argument_parser::base_parser::add_subcommand.
+		 */
+		void add_subcommand(std::string const &name, std::string const &help_text,
+							std::function<void(base_parser &)> const &factory) {
+			base::add_subcommand(name, help_text, [this, factory](argument_parser::base_parser &) { factory(*this); });
 		}
 
 		argument_parser::base_parser &to_v1() {
@@ -82,12 +157,41 @@ namespace argument_parser::v2 {
 			base::handle_arguments(convention_types);
 		}
 
+		template <typename... Conventions> void handle_arguments() {
+			base::template handle_arguments<Conventions...>();
+		}
+
 		template <typename T> std::optional<T> get_optional(std::string const &arg) {
 			return base::get_optional<T>(arg);
 		}
 
+		using argument_parser::base_parser::add_action_dependencies;
+		using argument_parser::base_parser::add_at_least_one_group;
+		using argument_parser::base_parser::add_mutually_exclusive_group;
+		using argument_parser::base_parser::add_requirements;
+		using argument_parser::base_parser::completion;
 		using argument_parser::base_parser::display_help;
+		using argument_parser::base_parser::exit_on_requirement_errors;
+		using argument_parser::base_parser::footprint;
+		using argument_parser::base_parser::load_image;
 		using argument_parser::base_parser::on_complete;
+		using argument_parser::base_parser::on_complete_async;
+		using argument_parser::base_parser::parse_cache_stats;
+		using argument_parser::base_parser::register_atomically;
+		using argument_parser::base_parser::reserve;
+		using argument_parser::base_parser::save_image;
+		using argument_parser::base_parser::schema_hash;
+		using argument_parser::base_parser::set_allocation_tracker;
+		using argument_parser::base_parser::set_concurrent_actions;
+		using argument_parser::base_parser::set_default;
+		using argument_parser::base_parser::set_default_factory;
+		using argument_parser::base_parser::set_dry_run;
+		using argument_parser::base_parser::set_long_name_matching;
+		using argument_parser::base_parser::set_parse_cache;
+		using argument_parser::base_parser::set_trace_recorder;
+		using argument_parser::base_parser::set_validator;
+		using argument_parser::base_parser::subcommand_path;
+		using argument_parser::base_parser::wait;
 
 	protected:
 		void set_program_name(std::string p) {
@@ -100,6 +204,7 @@ namespace argument_parser::v2 {
 
 		using argument_parser::base_parser::current_conventions;
 		using argument_parser::base_parser::reset_current_conventions;
+		using argument_parser::base_parser::track_phase;
 
 		void prepare_help_flag(bool should_exit = true) {
 			add_argument({{flags::ShortArgument, "h"},
@@ -114,246 +219,156 @@ namespace argument_parser::v2 {
 		}
 
 	private:
-		template <bool IsTyped, typename ActionType, typename T, typename ArgsMap>
-		void add_argument_impl(ArgsMap const &argument_pairs) {
-			if (argument_pairs.find(add_argument_flags::Positional) != argument_pairs.end()) {
-				add_positional_argument_impl<IsTyped, ActionType, T>(argument_pairs);
-				return;
-			}
+		using base = argument_parser::base_parser;
 
-			std::unordered_map<extended_add_argument_flags, bool> found_params{
-				{extended_add_argument_flags::IsTyped, IsTyped}};
+		static constexpr std::uint32_t handler_flags = flag_bit(add_argument_flags::Action) |
+													   flag_bit(add_argument_flags::Reference);
+		static constexpr std::uint32_t storage_flags = flag_bit(add_argument_flags::Append) |
+													   flag_bit(add_argument_flags::Count);
 
-			std::string short_arg, long_arg, help_text;
-			std::unique_ptr<action_base> action;
-			bool required = false;
+		template <typename Pairs>
+		static flag_slots<typename Pairs::value_type::second_type> collect_flags(Pairs const &pairs) {
+			flag_slots<typename Pairs::value_type::second_type> slots;
+			for (auto const &[flag, value] : pairs) {
+				slots.set(flag, value);
+			}
+			return slots;
+		}
 
-			if (argument_pairs.find(add_argument_flags::ShortArgument) != argument_pairs.end()) {
-				found_params[extended_add_argument_flags::ShortArgument] = true;
-				short_arg = get_or_throw<std::string>(argument_pairs.at(add_argument_flags::ShortArgument), "short");
+		template <bool IsTyped> static void check_modes(std::uint32_t modes) {
+			if (!IsTyped && (modes & flag_bit(add_argument_flags::Reference))) {
+				throw std::logic_error("Reference argument must be typed");
 			}
-			if (argument_pairs.find(add_argument_flags::LongArgument) != argument_pairs.end()) {
-				found_params[extended_add_argument_flags::LongArgument] = true;
-				long_arg = get_or_throw<std::string>(argument_pairs.at(add_argument_flags::LongArgument), "long");
-				if (short_arg.empty())
-					short_arg = "-";
-			} else {
-				if (!short_arg.empty())
-					long_arg = "-";
+			if ((modes & handler_flags) == handler_flags) {
+				throw std::logic_error("Cannot use both action and reference for the same argument");
 			}
-
-			if (argument_pairs.find(add_argument_flags::Action) != argument_pairs.end()) {
-				found_params[extended_add_argument_flags::Action] = true;
-				action = get_or_throw<ActionType>(argument_pairs.at(add_argument_flags::Action), "action").clone();
+			if ((modes & handler_flags) && (modes & storage_flags)) {
+				throw std::logic_error("Cannot combine an action or reference with append/count storage");
 			}
-			if (argument_pairs.find(add_argument_flags::HelpText) != argument_pairs.end()) {
-				help_text = get_or_throw<std::string>(argument_pairs.at(add_argument_flags::HelpText), "help");
+			if ((modes & storage_flags) == storage_flags) {
+				throw std::logic_error("Cannot use both append and count for the same argument");
 			}
-
-			if (argument_pairs.find(add_argument_flags::Required) != argument_pairs.end() &&
-				get_or_throw<bool>(argument_pairs.at(add_argument_flags::Required), "required")) {
-				required = true;
+			if (IsTyped && (modes & flag_bit(add_argument_flags::Count))) {
+				throw std::logic_error("Count storage does not take a value type");
 			}
-
-			if (argument_pairs.find(add_argument_flags::Reference) != argument_pairs.end()) {
-				if (!IsTyped) {
-					throw std::logic_error("Reference argument must be typed");
-				}
-
-				found_params[extended_add_argument_flags::Action] = true;
-				if constexpr (!std::is_same_v<T, void>) {
-					auto ref = get_or_throw<T *>(argument_pairs.at(add_argument_flags::Reference), "reference");
-					if (action) {
-						throw std::logic_error("Cannot use both action and reference for the same argument");
-					} else {
-						action = helpers::make_parametered_action<T>([ref](T const &t) { *ref = t; }).clone();
-					}
-				} else {
-					throw std::logic_error("Reference argument must not be void");
-				}
+			if (!IsTyped && (modes & flag_bit(add_argument_flags::Append))) {
+				throw std::logic_error("Append storage requires a value type");
 			}
+		}
 
-			auto suggested_add = suggest_candidate(found_params);
-			if (suggested_add == candidate_type::unknown) {
-				throw std::runtime_error("Could not match any add argument overload to given parameters. Are you "
-										 "missing some required parameter?");
+		template <typename ActionType, typename T, typename Value>
+		static ActionType take_action(flag_slots<Value> &&slots) {
+			if (auto const *action =
+					slots.template get<action_slot<ActionType>>(add_argument_flags::Action, "action")) {
+				return action->take();
 			}
-
-			if constexpr (IsTyped) {
-				switch (suggested_add) {
-				case candidate_type::typed_action:
-					if (help_text.empty()) {
-						if constexpr (internal::sfinae::has_format_hint<parsing_traits::parser_trait<T>>::value &&
-									  internal::sfinae::has_purpose_hint<parsing_traits::parser_trait<T>>::value) {
-							auto format_hint = parsing_traits::parser_trait<T>::format_hint;
-							auto purpose_hint = parsing_traits::parser_trait<T>::purpose_hint;
-							help_text = "Triggers action with " + std::string(purpose_hint) + " (" +
-										std::string(format_hint) + ")";
-						} else {
-							help_text = "Triggers action with value.";
-						}
-					}
-
-					base::add_argument(short_arg, long_arg, help_text, *static_cast<ActionType *>(&(*action)),
-									   required);
-					break;
-				case candidate_type::store_other:
-					if (help_text.empty()) {
-						if constexpr (internal::sfinae::has_format_hint<parsing_traits::parser_trait<T>>::value &&
-									  internal::sfinae::has_purpose_hint<parsing_traits::parser_trait<T>>::value) {
-							auto format_hint = parsing_traits::parser_trait<T>::format_hint;
-							auto purpose_hint = parsing_traits::parser_trait<T>::purpose_hint;
-							help_text =
-								"Accepts " + std::string(purpose_hint) + " in " + std::string(format_hint) + " format.";
-						} else {
-							help_text = "Accepts value.";
-						}
-					}
-
-					base::add_argument<T>(short_arg, long_arg, help_text, required);
-					break;
-				default:
-					throw std::runtime_error("Could not match the arguments against any overload.");
-				}
+			if constexpr (!std::is_same_v<T, void>) {
+				T *ref = *slots.template get<T *>(add_argument_flags::Reference, "reference");
+				return helpers::make_parametered_action<T>([ref](T const &value) { *ref = value; });
 			} else {
-				switch (suggested_add) {
-				case candidate_type::non_typed_action:
-					if (help_text.empty()) {
-						help_text = "Triggers action with no value.";
-					}
-
-					base::add_argument(short_arg, long_arg, help_text, *static_cast<ActionType *>(&(*action)),
-									   required);
-					break;
-				case candidate_type::store_boolean:
-					if (help_text.empty()) {
-						auto boolPurpose = parsing_traits::parser_trait<bool>::purpose_hint;
-						auto boolFormat = parsing_traits::parser_trait<bool>::format_hint;
-						help_text =
-							"Accepts " + std::string(boolPurpose) + " in " + std::string(boolFormat) + " format.";
-					}
-
-					base::add_argument(short_arg, long_arg, help_text, required);
-					break;
-				default:
-					throw std::runtime_error(
-						"Could not match the arguments against any overload. The suggested candidate was: " +
-						std::to_string((int(suggested_add))));
-				}
+				throw std::logic_error("Reference argument must not be void");
 			}
 		}
 
-		template <bool IsTyped, typename ActionType, typename T, typename ArgsMap>
-		void add_positional_argument_impl(ArgsMap const &argument_pairs) {
-			std::string positional_name =
-				get_or_throw<std::string>(argument_pairs.at(add_argument_flags::Positional), "positional");
-
-			std::string help_text;
-			std::unique_ptr<action_base> action;
-			bool required = false;
-			std::optional<int> position = std::nullopt;
+		template <bool IsTyped, typename ActionType, typename T, typename Value>
+		void add_argument_impl(flag_slots<Value> &&slots) {
+			auto scope = track_phase(instrumentation::parse_phase::registration);
+			if (slots.mask() & flag_bit(add_argument_flags::Positional)) {
+				add_positional_argument_impl<IsTyped, ActionType, T>(std::move(slots));
+				return;
+			}
 
-			if (argument_pairs.find(add_argument_flags::Action) != argument_pairs.end()) {
-				action = get_or_throw<ActionType>(argument_pairs.at(add_argument_flags::Action), "action").clone();
+			std::uint32_t modes = slots.mask() & handler_flags;
+			if (slots.enabled(add_argument_flags::Append, "append")) {
+				modes |= flag_bit(add_argument_flags::Append);
 			}
-			if (argument_pairs.find(add_argument_flags::HelpText) != argument_pairs.end()) {
-				help_text = get_or_throw<std::string>(argument_pairs.at(add_argument_flags::HelpText), "help");
+			if (slots.enabled(add_argument_flags::Count, "count")) {
+				modes |= flag_bit(add_argument_flags::Count);
 			}
-			if (argument_pairs.find(add_argument_flags::Required) != argument_pairs.end() &&
-				get_or_throw<bool>(argument_pairs.at(add_argument_flags::Required), "required")) {
-				required = true;
+			check_modes<IsTyped>(modes);
+
+			// an option with a single spelling registers "-" for the missing one
+			static std::string const none = "-";
+			static std::string const empty;
+			auto const *short_arg = slots.template get<std::string>(add_argument_flags::ShortArgument, "short");
+			auto const *long_arg = slots.template get<std::string>(add_argument_flags::LongArgument, "long");
+			if (short_arg == nullptr && long_arg == nullptr) {
+				throw std::runtime_error("Could not match any add argument overload to given parameters. Are you "
+										 "missing some required parameter?");
 			}
-			if (argument_pairs.find(add_argument_flags::Position) != argument_pairs.end()) {
-				position = get_or_throw<int>(argument_pairs.at(add_argument_flags::Position), "position");
+			if (long_arg == nullptr) {
+				long_arg = short_arg->empty() ? &empty : &none;
+			} else if (short_arg == nullptr || short_arg->empty()) {
+				short_arg = &none;
 			}
 
-			if (argument_pairs.find(add_argument_flags::Reference) != argument_pairs.end()) {
-				if (!IsTyped) {
-					throw std::logic_error("Reference argument must be typed");
-				}
-
-				if constexpr (!std::is_same_v<T, void>) {
-					auto ref = get_or_throw<T *>(argument_pairs.at(add_argument_flags::Reference), "reference");
-					if (action) {
-						throw std::logic_error("Cannot use both action and reference for the same argument");
-					} else {
-						action = helpers::make_parametered_action<T>([ref](T const &t) { *ref = t; }).clone();
-					}
-				} else {
-					throw std::logic_error("Reference argument must not be void");
-				}
-			}
-
-			if (help_text.empty()) {
-				if constexpr (IsTyped) {
-					if constexpr (internal::sfinae::has_format_hint<parsing_traits::parser_trait<T>>::value &&
-								  internal::sfinae::has_purpose_hint<parsing_traits::parser_trait<T>>::value) {
-						auto format_hint = parsing_traits::parser_trait<T>::format_hint;
-						auto purpose_hint = parsing_traits::parser_trait<T>::purpose_hint;
-						help_text =
-							"Accepts " + std::string(purpose_hint) + " in " + std::string(format_hint) + " format.";
-					} else {
-						help_text = "Accepts value.";
-					}
-				} else {
-					help_text = "Accepts value.";
-				}
-			}
+			auto const *help = slots.template get<std::string>(add_argument_flags::HelpText, "help");
+			std::string const &help_text = help != nullptr ? *help : empty;
+			bool const required = slots.enabled(add_argument_flags::Required, "required");
+			using form = generated_help::form;
 
 			if constexpr (IsTyped) {
-				if (action) {
-					base::add_positional_argument<T>(positional_name, help_text, *static_cast<ActionType *>(&(*action)),
-													 required, position);
+				if (modes & flag_bit(add_argument_flags::Append)) {
+					auto generated = generated_help::from_trait<T>(form::accepts_repeated);
+					base::template base_add_appending_argument<T>(*short_arg, *long_arg, help_text, required,
+																  generated);
+				} else if (modes & handler_flags) {
+					base::base_add_argument(*short_arg, *long_arg, help_text,
+											take_action<ActionType, T>(std::move(slots)), required,
+											generated_help::from_trait<T>(form::triggers_action));
 				} else {
-					base::template add_positional_argument<T>(positional_name, help_text, required, position);
+					base::template base_add_argument<T>(*short_arg, *long_arg, help_text, required,
+														generated_help::from_trait<T>(form::accepts));
 				}
 			} else {
-				base::template add_positional_argument<std::string>(positional_name, help_text, required, position);
+				if (modes & flag_bit(add_argument_flags::Count)) {
+					base::base_add_counting_argument(*short_arg, *long_arg, help_text, required,
+													 generated_help::literal("Counts occurrences."));
+				} else if (modes & handler_flags) {
+					base::base_add_argument(*short_arg, *long_arg, help_text,
+											take_action<ActionType, T>(std::move(slots)), required,
+											generated_help::literal("Triggers action with no value."));
+				} else {
+					base::template base_add_argument<void>(*short_arg, *long_arg, help_text, required,
+														   generated_help::from_trait<bool>(form::accepts));
+				}
 			}
 		}
 
-		using base = argument_parser::base_parser;
-		enum class extended_add_argument_flags { ShortArgument, LongArgument, Action, IsTyped };
-
-		enum class candidate_type { store_boolean, store_other, typed_action, non_typed_action, unknown };
-
-		template <typename T, size_t S>
-		bool satisfies_at_least_one(std::array<T, S> const &arr, std::unordered_map<T, bool> const &map) {
-			for (const auto &req : arr) {
-				if (map.find(req) != map.end())
-					return true;
+		template <bool IsTyped, typename ActionType, typename T, typename Value>
+		void add_positional_argument_impl(flag_slots<Value> &&slots) {
+			auto scope = track_phase(instrumentation::parse_phase::registration);
+			auto const &positional_name =
+				*slots.template get<std::string>(add_argument_flags::Positional, "positional");
+			if (slots.mask() & storage_flags) {
+				throw std::logic_error("Append and count storage are not supported for positional arguments");
 			}
-			return false;
-		}
+			std::uint32_t const modes = slots.mask() & handler_flags;
+			check_modes<IsTyped>(modes);
 
-		candidate_type suggest_candidate(std::unordered_map<extended_add_argument_flags, bool> const &available_vars) {
-			auto constexpr required_at_least_one = std::array<extended_add_argument_flags, 2>{
-				extended_add_argument_flags::ShortArgument, extended_add_argument_flags::LongArgument};
-			if (!satisfies_at_least_one(required_at_least_one, available_vars))
-				return candidate_type::unknown;
-
-			if (available_vars.find(extended_add_argument_flags::Action) != available_vars.end()) {
-				if (available_vars.at(extended_add_argument_flags::IsTyped))
-					return candidate_type::typed_action;
-				else
-					return candidate_type::non_typed_action;
+			static std::string const empty;
+			auto const *help = slots.template get<std::string>(add_argument_flags::HelpText, "help");
+			std::string const &help_text = help != nullptr ? *help : empty;
+			bool const required = slots.enabled(add_argument_flags::Required, "required");
+			std::optional<int> position = std::nullopt;
+			if (auto const *index = slots.template get<int>(add_argument_flags::Position, "position")) {
+				position = *index;
 			}
 
-			if (available_vars.at(extended_add_argument_flags::IsTyped))
-				return candidate_type::store_other;
-			return candidate_type::store_boolean;
-		}
-
-		template <typename T, typename I> T get_or_throw(typed_flag_value<I> const &v, std::string_view key) {
-			if (auto p = std::get_if<T>(&v))
-				return *p;
-			throw std::invalid_argument(std::string("variant type mismatch for key: ") + std::string(key));
-		}
-
-		template <typename T> T get_or_throw(non_typed_flag_value const &v, std::string_view key) {
-			if (auto p = std::get_if<T>(&v))
-				return *p;
-			throw std::invalid_argument(std::string("variant type mismatch for key: ") + std::string(key));
+			if constexpr (IsTyped) {
+				auto generated = generated_help::from_trait<T>(generated_help::form::accepts);
+				if (modes != 0) {
+					base::base_add_positional_argument(positional_name, help_text,
+													   take_action<ActionType, T>(std::move(slots)), required,
+													   position, generated);
+				} else {
+					base::template base_add_positional_argument<T>(positional_name, help_text, required, position,
+																   generated);
+				}
+			} else {
+				base::template base_add_positional_argument<std::string>(
+					positional_name, help_text, required, position, generated_help{generated_help::form::accepts});
+			}
 		}
 	};
 } // namespace argument_parser::v2
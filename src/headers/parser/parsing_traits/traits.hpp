@@ -2,7 +2,9 @@
 #ifndef PARSING_TRAITS_HPP
 #define PARSING_TRAITS_HPP
 
+#include <array>
 #include <string>
+#include <string_view>
 
 namespace argument_parser::parsing_traits {
 	using hint_type = const char *;
@@ -0,0 +1,71 @@
+#pragma once
+
+#ifdef __linux__
+#ifndef ARGUMENT_PARSER_PROC_SCANNER_HPP
+#define ARGUMENT_PARSER_PROC_SCANNER_HPP
+
+#include <fake_parser.hpp>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <vector>
+
+namespace argument_parser::proc {
+	/**
+	 * @brief Reads /proc/<pid>/cmdline of any process into a buffer that is reused across reads, normally with a
+	 * single pread. The views returned point into that buffer and are valid until the next read().
+	 */
+	class cmdline_reader {
+	public:
+		/** @brief False if the process is gone, unreadable, or has no command line (kernel threads). */
+		bool read(pid_t pid);
+		[[nodiscard]] std::string_view program() const;
+		/** @brief argv[0] first. */
+		[[nodiscard]] std::vector<std::string_view> const &tokens() const;
+
+	private:
+		std::vector<char> buffer = std::vector<char>(4096);
+		std::vector<std::string_view> views;
+	};
+
+	/** @brief Registers the options to parse against; called once per process on a fresh parser. */
+	using schema = std::function<void(v2::base_parser &)>;
+
+	struct scan_result {
+		pid_t pid = 0;
+		std::string program;
+		std::unique_ptr<v2::fake_parser> parsed; // read values with get_optional; nullptr when error is set
+		std::string error;
+	};
+
+	struct scan_options {
+		std::function<bool(std::string_view program)> filter; // receives argv[0]; empty accepts every process
+		unsigned max_threads = 0;							   // 0 uses the hardware concurrency
+	};
+
+	/** @brief Filter accepting processes whose argv[0] has the given base name. */
+	std::function<bool(std::string_view)> program_named(std::string name);
+
+	/**
+	 * @brief Parses the command line of one process in dry-run mode (see base_parser::set_dry_run), so stored
+	 * values are recorded but no action runs. Returns false if the command line could not be read.
+	 */
+	bool parse_process(pid_t pid, schema const &options,
+					   std::initializer_list<conventions::convention const *const> convention_types,
+					   cmdline_reader &reader, scan_result &result);
+
+	/**
+	 * @brief Walks /proc and parses every process accepted by the filter, spread over a pool of threads.
+	 * Results are ordered by pid. Processes that exit during the scan are left out; parse failures are reported in
+	 * scan_result::error.
+	 */
+	std::vector<scan_result> scan(schema const &options,
+								  std::initializer_list<conventions::convention const *const> convention_types,
+								  scan_options const &settings = {});
+} // namespace argument_parser::proc
+
+#endif // ARGUMENT_PARSER_PROC_SCANNER_HPP
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+#ifndef ARGPARSE_PLUGIN_ABI_H
+#define ARGPARSE_PLUGIN_ABI_H
+
+/*
+ * C ABI between argument_parser and subcommand plugins loaded from shared objects.
+ *
+ * A plugin exports ARGPARSE_PLUGIN_ENTRY_POINT with the signature argparse_plugin_register_fn. It is called once,
+ * when its subcommand is selected, and registers its options through the function table in argparse_plugin_host.
+ * All strings are copied by the host; callbacks and their user_data must stay valid while the plugin is loaded.
+ * Registration functions return 0 on success; on failure last_error() describes the problem.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARGPARSE_PLUGIN_ABI_VERSION 1
+#define ARGPARSE_PLUGIN_ENTRY_POINT "argparse_plugin_register"
+
+#ifdef _WIN32
+#define ARGPARSE_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define ARGPARSE_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+typedef void (*argparse_plugin_action_fn)(void *user_data);
+typedef void (*argparse_plugin_value_fn)(void *user_data, const char *value);
+
+typedef struct argparse_plugin_host {
+	unsigned abi_version;
+	void *context;
+	const char *subcommand;
+
+	/* Boolean flag, read back with get_optional<bool>(). short_name or long_name may be NULL, not both. */
+	int (*add_flag)(void *context, const char *short_name, const char *long_name, const char *help_text, int required);
+	/* Flag without a value that invokes callback. */
+	int (*add_action)(void *context, const char *short_name, const char *long_name, const char *help_text,
+					  int required, argparse_plugin_action_fn callback, void *user_data);
+	/* Option with a value; callback may be NULL to only store it for get_optional<std::string>(). */
+	int (*add_option)(void *context, const char *short_name, const char *long_name, const char *help_text,
+					  int required, argparse_plugin_value_fn callback, void *user_data);
+	/* Positional argument; position < 0 appends. callback may be NULL to only store the value. */
+	int (*add_positional)(void *context, const char *name, const char *help_text, int required, int position,
+						  argparse_plugin_value_fn callback, void *user_data);
+	const char *(*last_error)(void *context);
+} argparse_plugin_host;
+
+typedef int (*argparse_plugin_register_fn)(argparse_plugin_host const *host);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARGPARSE_PLUGIN_ABI_H */
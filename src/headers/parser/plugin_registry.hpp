@@ -0,0 +1,48 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_PLUGIN_REGISTRY_HPP
+#define ARGUMENT_PARSER_PLUGIN_REGISTRY_HPP
+
+#include <optional>
+#include <parser_v2.hpp>
+#include <plugin_abi.h>
+#include <string>
+#include <vector>
+
+namespace argument_parser::plugins {
+	struct plugin_entry {
+		std::string name;
+		std::string library_path;
+		std::string help_text;
+	};
+
+	/**
+	 * @brief Maps subcommand names to shared objects implementing them.
+	 *
+	 * install() registers every entry as a lazy subcommand. A library is loaded only when its subcommand is first
+	 * selected; it then registers its options through the C ABI in plugin_abi.h on every selection and stays loaded
+	 * until the parser is destroyed, so reparsing does not load it again.
+	 */
+	class plugin_registry {
+	public:
+		void add(std::string const &name, std::string const &library_path, std::string const &help_text = "");
+		[[nodiscard]] std::optional<plugin_entry> find(std::string const &name) const;
+		[[nodiscard]] std::vector<plugin_entry> const &entries() const;
+		void install(v2::base_parser &parser) const;
+
+	private:
+		std::vector<plugin_entry> plugins; // sorted by name
+	};
+
+	void add_plugin_subcommand(v2::base_parser &parser, std::string const &name, std::string const &library_path,
+							   std::string const &help_text = "");
+
+	/**
+	 * @brief Loads the library and runs its entry point against the parser immediately. The library stays loaded for
+	 * as long as the parser holds actions from it.
+	 * Throws std::runtime_error if the library, the entry point or any registration fails; the options registered
+	 * before the failure are removed again, so the parser is left as it was.
+	 */
+	void load_plugin(v2::base_parser &parser, std::string const &subcommand, std::string const &library_path);
+} // namespace argument_parser::plugins
+
+#endif // ARGUMENT_PARSER_PLUGIN_REGISTRY_HPP
@@ -0,0 +1,146 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_SMALL_FUNCTION_HPP
+#define ARGUMENT_PARSER_SMALL_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace argument_parser::internal {
+	template <typename Signature, std::size_t Capacity = 4 * sizeof(void *)> class small_function;
+
+	/**
+	 * @brief A std::function replacement for actions that keeps callables of up to Capacity bytes inline.
+	 *
+	 * Function pointers, the lambdas the parser registers itself (an id and `this`) and a wrapped std::function all
+	 * fit, so neither construction nor moving allocates for them. Bigger callables, or callables that may throw while
+	 * moving, are stored on the heap. It is move-only, like the actions holding it, so move-only callables work too.
+	 * Calling an empty small_function throws std::bad_function_call.
+	 */
+	template <typename R, typename... Args, std::size_t Capacity> class small_function<R(Args...), Capacity> {
+	public:
+		small_function() noexcept = default;
+
+		template <typename F, typename Stored = std::decay_t<F>,
+				  typename = std::enable_if_t<!std::is_same_v<Stored, small_function> &&
+											  std::is_invocable_r_v<R, Stored &, Args...>>>
+		small_function(F &&callable) { // NOLINT(google-explicit-constructor): mirrors std::function
+			// a function name decays to a pointer that cannot be null; only an actual pointer argument is checked
+			if constexpr (std::is_pointer_v<std::remove_reference_t<F>> ||
+						  std::is_member_pointer_v<std::remove_reference_t<F>>) {
+				if (callable == nullptr) {
+					return;
+				}
+			} else if constexpr (is_std_function<Stored>::value) {
+				if (!callable) { // an empty std::function stays empty
+					return;
+				}
+			}
+			if constexpr (stored_inline<Stored>) {
+				::new (static_cast<void *>(storage)) Stored(std::forward<F>(callable));
+			} else {
+				::new (static_cast<void *>(storage)) Stored *(new Stored(std::forward<F>(callable)));
+			}
+			ops = &operations_for<Stored>;
+		}
+
+		small_function(small_function &&other) noexcept : ops(std::exchange(other.ops, nullptr)) {
+			if (ops != nullptr) {
+				ops->move(other.storage, storage);
+			}
+		}
+
+		small_function(small_function const &) = delete;
+		small_function &operator=(small_function const &) = delete;
+
+		small_function &operator=(small_function &&other) noexcept {
+			if (this != &other) {
+				reset();
+				ops = std::exchange(other.ops, nullptr);
+				if (ops != nullptr) {
+					ops->move(other.storage, storage);
+				}
+			}
+			return *this;
+		}
+
+		~small_function() {
+			reset();
+		}
+
+		R operator()(Args... args) const {
+			if (ops == nullptr) {
+				throw std::bad_function_call();
+			}
+			return ops->invoke(storage, std::forward<Args>(args)...);
+		}
+
+		explicit operator bool() const noexcept {
+			return ops != nullptr;
+		}
+
+		/** @brief True when the callable lives in the inline buffer (or there is none). */
+		[[nodiscard]] bool is_inline() const noexcept {
+			return ops == nullptr || ops->is_inline;
+		}
+
+	private:
+		template <typename F> struct is_std_function : std::false_type {};
+		template <typename S> struct is_std_function<std::function<S>> : std::true_type {};
+
+		struct operations {
+			R (*invoke)(unsigned char *storage, Args &&...args);
+			void (*move)(unsigned char *from, unsigned char *to) noexcept; // also destroys the source
+			void (*destroy)(unsigned char *storage) noexcept;
+			bool is_inline;
+		};
+
+		template <typename F>
+		static constexpr bool stored_inline = sizeof(F) <= Capacity && alignof(F) <= alignof(void *) &&
+											  std::is_nothrow_move_constructible_v<F>;
+
+		template <typename F> static F &target(unsigned char *storage) noexcept {
+			if constexpr (stored_inline<F>) {
+				return *std::launder(reinterpret_cast<F *>(storage));
+			} else {
+				return **std::launder(reinterpret_cast<F **>(storage));
+			}
+		}
+
+		template <typename F>
+		static constexpr operations operations_for{
+			[](unsigned char *storage, Args &&...args) -> R {
+				return std::invoke(target<F>(storage), std::forward<Args>(args)...);
+			},
+			[](unsigned char *from, unsigned char *to) noexcept {
+				if constexpr (stored_inline<F>) {
+					::new (static_cast<void *>(to)) F(std::move(target<F>(from)));
+					target<F>(from).~F();
+				} else {
+					::new (static_cast<void *>(to)) F *(&target<F>(from));
+				}
+			},
+			[](unsigned char *storage) noexcept {
+				if constexpr (stored_inline<F>) {
+					target<F>(storage).~F();
+				} else {
+					delete &target<F>(storage);
+				}
+			},
+			stored_inline<F>};
+
+		void reset() noexcept {
+			if (ops != nullptr) {
+				ops->destroy(storage);
+				ops = nullptr;
+			}
+		}
+
+		alignas(void *) mutable unsigned char storage[Capacity];
+		operations const *ops = nullptr;
+	};
+} // namespace argument_parser::internal
+
+#endif // ARGUMENT_PARSER_SMALL_FUNCTION_HPP
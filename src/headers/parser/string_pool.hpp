@@ -0,0 +1,44 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_STRING_POOL_HPP
+#define ARGUMENT_PARSER_STRING_POOL_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace argument_parser::internal {
+	/**
+	 * @brief Append-only arena holding each distinct schema string once (option names, positional names, help text).
+	 *
+	 * Views returned by intern() stay valid for the lifetime of the pool; nothing is ever moved or freed early.
+	 */
+	class string_pool {
+	public:
+		string_pool() = default;
+		string_pool(string_pool const &) = delete;
+		string_pool &operator=(string_pool const &) = delete;
+
+		[[nodiscard]] std::string_view intern(std::string_view text);
+		/** @brief Copies the concatenation of parts without deduplicating, for strings known to be unique. */
+		[[nodiscard]] std::string_view copy(std::initializer_list<std::string_view> parts);
+		[[nodiscard]] std::size_t size() const noexcept;
+		[[nodiscard]] std::size_t bytes() const noexcept;
+
+	private:
+		static constexpr std::size_t block_size = 16 * 1024;
+
+		[[nodiscard]] char *allocate(std::size_t length);
+
+		std::vector<std::unique_ptr<char[]>> blocks;
+		char *current = nullptr; // block receiving short strings
+		std::size_t block_used = 0;
+		std::size_t reserved_bytes = 0;
+		std::size_t copied = 0; // strings stored by copy(), not in the set
+		std::unordered_set<std::string_view> strings;
+	};
+} // namespace argument_parser::internal
+
+#endif // ARGUMENT_PARSER_STRING_POOL_HPP
@@ -0,0 +1,216 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_VALIDATORS_HPP
+#define ARGUMENT_PARSER_VALIDATORS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace argument_parser::validators {
+	enum class failure_policy { fail_loud, fail_skip };
+
+	/**
+	 * @brief A compiled check over parsed values. Built once at registration and shared by every copy of the option.
+	 *
+	 * The vector overloads let list-valued options validate a whole batch with one virtual call per constraint.
+	 */
+	template <typename T> class constraint {
+	public:
+		explicit constraint(std::string description) : text(std::move(description)) {}
+		virtual ~constraint() = default;
+
+		[[nodiscard]] virtual bool accepts(T const &value) const = 0;
+		/** @brief Index of the first rejected element, or values.size() if all are accepted. */
+		[[nodiscard]] virtual std::size_t first_rejected(std::vector<T> const &values) const = 0;
+		virtual void remove_rejected(std::vector<T> &values) const = 0;
+
+		[[nodiscard]] std::string const &description() const {
+			return text;
+		}
+
+	private:
+		std::string text;
+	};
+
+	template <typename T> using constraint_ptr = std::shared_ptr<constraint<T> const>;
+
+	namespace detail {
+		template <typename T, typename = void> struct is_streamable : std::false_type {};
+
+		template <typename T>
+		struct is_streamable<T, std::void_t<decltype(std::declval<std::ostream &>() << std::declval<T const &>())>>
+			: std::true_type {};
+
+		template <typename T> std::string describe(T const &value) {
+			if constexpr (is_streamable<T>::value) {
+				std::stringstream ss;
+				ss << std::boolalpha << value;
+				return ss.str();
+			} else {
+				return "<value>";
+			}
+		}
+
+		// the per-element check is a non-virtual call so the batch loops below inline it
+		template <typename T, typename Derived> class basic_constraint : public constraint<T> {
+		public:
+			using constraint<T>::constraint;
+
+			[[nodiscard]] bool accepts(T const &value) const final {
+				return derived().check(value);
+			}
+
+			[[nodiscard]] std::size_t first_rejected(std::vector<T> const &values) const final {
+				auto const &self = derived();
+				auto it = std::find_if_not(values.begin(), values.end(), [&self](T const &v) { return self.check(v); });
+				return static_cast<std::size_t>(it - values.begin());
+			}
+
+			void remove_rejected(std::vector<T> &values) const final {
+				auto const &self = derived();
+				auto rejected = [&self](T const &v) { return !self.check(v); };
+				values.erase(std::remove_if(values.begin(), values.end(), rejected), values.end());
+			}
+
+		private:
+			Derived const &derived() const {
+				return static_cast<Derived const &>(*this);
+			}
+		};
+
+		template <typename T> class range_constraint : public basic_constraint<T, range_constraint<T>> {
+		public:
+			range_constraint(T min, T max)
+				: basic_constraint<T, range_constraint<T>>("expected a value between " + describe(min) + " and " +
+														   describe(max)),
+				  min(std::move(min)), max(std::move(max)) {}
+
+			bool check(T const &value) const {
+				return !(value < min) && !(max < value);
+			}
+
+		private:
+			T min;
+			T max;
+		};
+
+		template <typename T> class set_constraint : public basic_constraint<T, set_constraint<T>> {
+		public:
+			explicit set_constraint(std::vector<T> allowed)
+				: basic_constraint<T, set_constraint<T>>(describe_set(allowed)), allowed(std::move(allowed)) {
+				std::sort(this->allowed.begin(), this->allowed.end());
+			}
+
+			bool check(T const &value) const {
+				return std::binary_search(allowed.begin(), allowed.end(), value);
+			}
+
+		private:
+			static std::string describe_set(std::vector<T> const &values) {
+				std::string text = "expected one of ";
+				for (std::size_t i = 0; i < values.size(); ++i) {
+					text += (i == 0 ? "" : ", ") + describe(values[i]);
+				}
+				return text;
+			}
+
+			std::vector<T> allowed; // sorted
+		};
+
+		template <typename T> class predicate_constraint : public basic_constraint<T, predicate_constraint<T>> {
+		public:
+			predicate_constraint(std::function<bool(T const &)> predicate, std::string description)
+				: basic_constraint<T, predicate_constraint<T>>(std::move(description)),
+				  predicate(std::move(predicate)) {}
+
+			bool check(T const &value) const {
+				return predicate(value);
+			}
+
+		private:
+			std::function<bool(T const &)> predicate;
+		};
+	} // namespace detail
+
+	template <typename T> constraint_ptr<T> range(T min, T max) {
+		return std::make_shared<detail::range_constraint<T> const>(std::move(min), std::move(max));
+	}
+
+	template <typename T> constraint_ptr<T> one_of(std::vector<T> allowed) {
+		return std::make_shared<detail::set_constraint<T> const>(std::move(allowed));
+	}
+
+	inline constraint_ptr<std::string> one_of(std::initializer_list<const char *> allowed) {
+		return one_of(std::vector<std::string>(allowed.begin(), allowed.end()));
+	}
+
+	template <typename T, typename Predicate>
+	constraint_ptr<T> predicate(Predicate &&check, std::string description = "rejected by a custom check") {
+		return std::make_shared<detail::predicate_constraint<T> const>(
+			std::function<bool(T const &)>(std::forward<Predicate>(check)), std::move(description));
+	}
+
+	/**
+	 * @brief Full-match regex constraint. Each distinct pattern is compiled once per process and shared by every
+	 * constraint that uses it. Throws std::logic_error on an invalid pattern.
+	 */
+	constraint_ptr<std::string> matches(std::string const &pattern);
+
+	/**
+	 * @brief An ordered set of constraints plus what to do when one rejects a value.
+	 *
+	 * fail_loud reports the value as a parse error; fail_skip drops it as if it had not been given, or removes the
+	 * rejected elements of a list-valued option.
+	 */
+	template <typename T> class validator {
+	public:
+		validator(std::initializer_list<constraint_ptr<T>> constraints,
+				  failure_policy policy = failure_policy::fail_loud)
+			: checks(constraints), on_failure(policy) {}
+
+		validator(std::vector<constraint_ptr<T>> constraints, failure_policy policy = failure_policy::fail_loud)
+			: checks(std::move(constraints)), on_failure(policy) {}
+
+		[[nodiscard]] failure_policy policy() const {
+			return on_failure;
+		}
+
+		/** @brief The first constraint rejecting value, or nullptr. */
+		[[nodiscard]] constraint<T> const *rejecting(T const &value) const {
+			for (auto const &check : checks) {
+				if (!check->accepts(value)) {
+					return check.get();
+				}
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @brief Validates a whole list. Under fail_skip rejected elements are removed and an empty string returned;
+		 * under fail_loud the error text for the first rejected element is returned and values are left untouched.
+		 */
+		[[nodiscard]] std::string apply(std::vector<T> &values) const {
+			for (auto const &check : checks) {
+				if (on_failure == failure_policy::fail_skip) {
+					check->remove_rejected(values);
+				} else if (auto index = check->first_rejected(values); index != values.size()) {
+					return "value #" + std::to_string(index + 1) + " ${KEY} is not accepted: " + check->description();
+				}
+			}
+			return {};
+		}
+
+	private:
+		std::vector<constraint_ptr<T>> checks;
+		failure_policy on_failure;
+	};
+} // namespace argument_parser::validators
+
+#endif // ARGUMENT_PARSER_VALIDATORS_HPP
@@ -1,23 +1,14 @@
 #include "gnu_argument_convention.hpp"
 #include "base_convention.hpp"
-#include <stdexcept>
-
-bool starts_with(std::string const &s, std::string const &prefix) {
-	return s.rfind(prefix, 0) == 0;
-}
+#include "static_conventions.hpp"
 
 namespace argument_parser::conventions::implementations {
 	parsed_argument gnu_argument_convention::get_argument(std::string const &raw) const {
-		if (starts_with(raw, long_prec()))
-			return {argument_type::LONG, raw.substr(2)};
-		else if (starts_with(raw, short_prec()))
-			return {argument_type::SHORT, raw.substr(1)};
-		else
-			return {argument_type::ERROR, "GNU standard convention does not allow arguments without a preceding dash."};
+		return static_dispatch::to_parsed_argument<static_dispatch::gnu>(raw);
 	}
 
-	std::string gnu_argument_convention::extract_value(std::string const & /*raw*/) const {
-		throw std::runtime_error("No inline value in standard GNU convention.");
+	std::string gnu_argument_convention::extract_value(std::string const &raw) const {
+		return static_dispatch::inline_value<static_dispatch::gnu>(raw);
 	}
 
 	bool gnu_argument_convention::requires_next_token() const {
@@ -29,11 +20,11 @@ namespace argument_parser::conventions::implementations {
 	}
 
 	std::string gnu_argument_convention::short_prec() const {
-		return "-";
+		return std::string(static_dispatch::gnu::short_prefix);
 	}
 
 	std::string gnu_argument_convention::long_prec() const {
-		return "--";
+		return std::string(static_dispatch::gnu::long_prefix);
 	}
 
 	std::vector<convention_features> gnu_argument_convention::get_features() const {
@@ -65,21 +56,11 @@ namespace argument_parser::conventions::implementations {
 
 namespace argument_parser::conventions::implementations {
 	parsed_argument gnu_equal_argument_convention::get_argument(std::string const &raw) const {
-		auto pos = raw.find('=');
-		auto arg = pos != std::string::npos ? raw.substr(0, pos) : raw;
-		if (starts_with(arg, long_prec()))
-			return {argument_type::LONG, arg.substr(2)};
-		else if (starts_with(arg, short_prec()))
-			return {argument_type::SHORT, arg.substr(1)};
-		else
-			return {argument_type::ERROR, "GNU standard convention does not allow arguments without a preceding dash."};
+		return static_dispatch::to_parsed_argument<static_dispatch::gnu_equal>(raw);
 	}
 
 	std::string gnu_equal_argument_convention::extract_value(std::string const &raw) const {
-		auto pos = raw.find('=');
-		if (pos == std::string::npos || pos + 1 >= raw.size())
-			throw std::runtime_error("Expected value after '='.");
-		return raw.substr(pos + 1);
+		return static_dispatch::inline_value<static_dispatch::gnu_equal>(raw);
 	}
 
 	bool gnu_equal_argument_convention::requires_next_token() const {
@@ -91,11 +72,11 @@ namespace argument_parser::conventions::implementations {
 	}
 
 	std::string gnu_equal_argument_convention::short_prec() const {
-		return "-";
+		return std::string(static_dispatch::gnu_equal::short_prefix);
 	}
 
 	std::string gnu_equal_argument_convention::long_prec() const {
-		return "--";
+		return std::string(static_dispatch::gnu_equal::long_prefix);
 	}
 
 	std::pair<std::string, std::string> gnu_equal_argument_convention::make_help_text(std::string const &short_arg,
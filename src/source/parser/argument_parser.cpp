@@ -1,8 +1,14 @@
 #include "argument_parser.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -22,33 +28,58 @@ private:
 	std::function<void()> func;
 };
 
-bool contains(std::unordered_map<std::string, int> const &map, std::string const &key) {
+bool contains(std::unordered_map<std::string_view, int> const &map, std::string_view key) {
 	return map.find(key) != map.end();
 }
 
-namespace argument_parser {
-	argument::argument()
-		: id(0), name(), action(std::make_unique<non_parametered_action>([]() {})), required(false), invoked(false) {}
+std::size_t heap_bytes(std::string const &s) {
+	static const std::size_t inline_capacity = std::string{}.capacity();
+	return s.capacity() > inline_capacity ? s.capacity() + 1 : 0;
+}
 
-	argument::argument(const argument &other)
-		: id(other.id), name(other.name), action(other.action->clone()), required(other.required),
-		  invoked(other.invoked), help_text(other.help_text), positional(other.positional),
-		  position_index(other.position_index) {}
+template <typename T> std::size_t heap_bytes(T const &) {
+	return 0;
+}
 
-	argument &argument::operator=(const argument &other) {
-		if (this != &other) {
-			id = other.id;
-			name = other.name;
-			action = other.action->clone();
-			required = other.required;
-			invoked = other.invoked;
-			help_text = other.help_text;
-			positional = other.positional;
-			position_index = other.position_index;
+// Estimates the resident size of a node-based hash map: bucket array, one node per entry (next pointer, cached hash
+// and the value itself) and whatever the keys/values own on the heap.
+template <typename Map, typename ValueBytes> std::size_t map_bytes(Map const &map, ValueBytes const &value_bytes) {
+	std::size_t bytes = sizeof(Map) + map.bucket_count() * sizeof(void *);
+	for (auto const &[key, value] : map) {
+		bytes += sizeof(void *) + sizeof(std::size_t) + sizeof(typename Map::value_type);
+		bytes += heap_bytes(key) + value_bytes(value);
+	}
+	return bytes;
+}
+
+template <typename Map> std::size_t map_bytes(Map const &map) {
+	return map_bytes(map, [](auto const &value) { return heap_bytes(value); });
+}
+
+namespace argument_parser {
+	std::string generated_help::render() const {
+		std::string const purpose_text = purpose != nullptr ? purpose : "value";
+		bool const hinted = purpose != nullptr && format != nullptr;
+		switch (shape) {
+		case form::literal:
+			return text;
+		case form::accepts:
+			return hinted ? "Accepts " + purpose_text + " in " + format + " format." : "Accepts value.";
+		case form::accepts_repeated:
+			return hinted ? "Accepts " + purpose_text + " in " + format + " format. May be repeated."
+						  : "Accepts value. May be repeated.";
+		case form::triggers_action:
+			return hinted ? "Triggers action with " + purpose_text + " (" + format + ")"
+						  : "Triggers action with value.";
+		case form::none:
+			break;
 		}
-		return *this;
+		return {};
 	}
 
+	argument::argument()
+		: id(0), name(), action(std::make_unique<non_parametered_action>([]() {})), required(false), invoked(false) {}
+
 	bool argument::expects_parameter() const {
 		return action->expects_parameter();
 	}
@@ -62,11 +93,14 @@ namespace argument_parser {
 	}
 
 	std::string argument::get_name() const {
-		return name;
+		return std::string(name);
 	}
 
 	std::string argument::get_help_text() const {
-		return help_text;
+		if (help_text.empty()) {
+			return default_help.render();
+		}
+		return std::string(help_text);
 	}
 
 	void argument::set_required(bool val) {
@@ -77,7 +111,7 @@ namespace argument_parser {
 		invoked = val;
 	}
 
-	void argument::set_help_text(std::string const &text) {
+	void argument::set_help_text(std::string_view text) {
 		help_text = text;
 	}
 
@@ -97,14 +131,271 @@ namespace argument_parser {
 		position_index = idx;
 	}
 
+	accumulation_mode argument::get_accumulation() const {
+		return accumulation;
+	}
+
+	void argument::set_accumulation(accumulation_mode mode) {
+		accumulation = mode;
+	}
+
+	bool argument::is_storing() const {
+		return storing;
+	}
+
+	void argument::set_storing(bool val) {
+		storing = val;
+	}
+
 	void base_parser::on_complete(std::function<void(base_parser const &)> const &handler) {
+		auto scope = track_phase(instrumentation::parse_phase::registration);
 		on_complete_events.emplace_back(handler);
 	}
 
+	void base_parser::on_complete_async(std::string const &name,
+										std::function<void(base_parser const &)> const &handler,
+										std::vector<std::string> const &after) {
+		auto scope = track_phase(instrumentation::parse_phase::registration);
+		auto named = [this](std::string const &candidate) {
+			return std::find_if(async_on_complete_events.begin(), async_on_complete_events.end(),
+								[&candidate](async_on_complete_event const &event) { return event.name == candidate; });
+		};
+		if (named(name) != async_on_complete_events.end()) {
+			throw std::logic_error("on_complete handler already registered: " + name);
+		}
+
+		async_on_complete_event event{name, handler, {}, {}};
+		for (auto const &predecessor : after) {
+			auto it = named(predecessor);
+			if (it == async_on_complete_events.end()) {
+				throw std::logic_error("on_complete handler " + name + " waits for unknown handler: " + predecessor);
+			}
+			event.after.push_back(static_cast<std::size_t>(it - async_on_complete_events.begin()));
+		}
+		async_on_complete_events.push_back(std::move(event));
+	}
+
+	std::shared_future<void> base_parser::completion(std::string const &name) const {
+		for (auto const &event : async_on_complete_events) {
+			if (event.name == name) {
+				return event.done;
+			}
+		}
+		throw std::logic_error("Unknown on_complete handler: " + name);
+	}
+
+	void base_parser::wait() const {
+		for (auto const &event : async_on_complete_events) {
+			if (event.done.valid()) {
+				event.done.get();
+			}
+		}
+	}
+
+	void base_parser::join_async_on_complete_events() const noexcept {
+		for (auto const &event : async_on_complete_events) {
+			if (event.done.valid()) {
+				event.done.wait();
+			}
+		}
+	}
+
+	base_parser::~base_parser() {
+		join_async_on_complete_events();
+	}
+
+	void base_parser::add_counting_argument(std::string const &short_arg, std::string const &long_arg,
+											std::string const &help_text, bool required) {
+		base_add_counting_argument(short_arg, long_arg, help_text, required);
+	}
+
+	void base_parser::base_add_counting_argument(std::string const &short_arg, std::string const &long_arg,
+												 std::string const &help_text, bool required,
+												 generated_help generated) {
+		auto scope = track_phase(instrumentation::parse_phase::registration);
+		assert_argument_not_exist(short_arg, long_arg);
+		int id = id_counter.fetch_add(1);
+		auto action = helpers::make_non_parametered_action([id, this] {
+			auto &slot = stored_arguments[id];
+			if (auto *count = std::any_cast<int>(&slot)) {
+				++*count;
+			} else {
+				slot = 1;
+			}
+		});
+		argument arg(id, intern_option_name(short_arg, long_arg), std::move(action));
+		set_argument_status(required, help_text, generated, arg);
+		arg.set_accumulation(accumulation_mode::count);
+		arg.set_storing(true);
+		place_argument(id, std::move(arg), short_arg, long_arg);
+		value_codecs[id] = image::codec_for<int>();
+	}
+
+	std::size_t base_parser::expected_occurrences(int id) const {
+		auto it = occurrence_counts.find(id);
+		return it != occurrence_counts.end() ? it->second : 1;
+	}
+
+	void base_parser::set_default_factory(std::string const &arg, std::function<std::any()> const &factory) {
+		auto id = find_argument_id(arg);
+		if (!id.has_value()) {
+			throw std::runtime_error("Cannot set a default for unknown argument: " + arg);
+		}
+		default_factories[id.value()] = factory;
+		materialized_defaults.erase(id.value());
+	}
+
+	std::any const *base_parser::default_value(int id) const {
+		std::lock_guard<std::mutex> lock(*defaults_mutex);
+		auto memoized = materialized_defaults.find(id);
+		if (memoized != materialized_defaults.end()) {
+			return &memoized->second;
+		}
+
+		auto factory = default_factories.find(id);
+		if (factory == default_factories.end()) {
+			return nullptr;
+		}
+		return &materialized_defaults.emplace(id, factory->second()).first->second;
+	}
+
+	std::any const *base_parser::stored_value(int id) const {
+		auto stored = stored_arguments.find(id);
+		if (stored != stored_arguments.end() && stored->second.has_value()) {
+			return &stored->second;
+		}
+		auto arg = argument_map.find(id);
+		if (restored_result == nullptr || arg == argument_map.end()) {
+			return nullptr;
+		}
+		auto const index = arg->second.index;
+		auto const &values = restored_result->values;
+		auto restored = std::lower_bound(values.begin(), values.end(), index,
+										 [](auto const &entry, std::size_t key) { return entry.first < key; });
+		if (restored != values.end() && restored->first == index && restored->second.has_value()) {
+			return &restored->second;
+		}
+		return nullptr;
+	}
+
+	bool base_parser::subcommand_less(subcommand_entry const &entry, std::string const &name) {
+		return entry.name < name;
+	}
+
+	void base_parser::add_subcommand(std::string const &name, std::string const &help_text,
+									 std::function<void(base_parser &)> const &factory) {
+		auto scope = track_phase(instrumentation::parse_phase::registration);
+		auto it = std::lower_bound(subcommands.begin(), subcommands.end(), name, subcommand_less);
+		if (it != subcommands.end() && it->name == name) {
+			throw std::runtime_error("Subcommand '" + name + "' already exists!");
+		}
+		subcommands.insert(it, {name, help_text, factory});
+		++schema_version; // a cached parse may have taken the name as a positional value
+	}
+
+	std::vector<std::string> const &base_parser::subcommand_path() const {
+		return selected_subcommands;
+	}
+
+	bool base_parser::try_select_subcommand(std::string const &token) {
+		auto it = std::lower_bound(subcommands.begin(), subcommands.end(), token, subcommand_less);
+		if (it == subcommands.end() || it->name != token) {
+			return false;
+		}
+
+		// the level moves into the mark, so rollback_subcommands() can offer it again; the factory may register the
+		// next level of subcommands
+		auto const factory = it->factory;
+		subcommand_marks.push_back(mark_schema());
+		subcommand_marks.back().subcommands = std::move(subcommands);
+		subcommands.clear();
+		selected_subcommands.push_back(token);
+		factory(*this);
+		return true;
+	}
+
+	void base_parser::rollback_subcommands() {
+		if (subcommand_marks.empty()) {
+			return;
+		}
+
+		auto &root = subcommand_marks.front();
+		rollback_schema(root);
+		subcommands = std::move(root.subcommands);
+		selected_subcommands.clear();
+		subcommand_marks.clear();
+	}
+
+	void base_parser::register_atomically(std::function<void()> const &registrations) {
+		auto mark = mark_schema();
+		mark.subcommands = subcommands;
+		try {
+			registrations();
+		} catch (...) {
+			rollback_schema(mark);
+			subcommands = std::move(mark.subcommands);
+			throw;
+		}
+	}
+
+	base_parser::subcommand_mark base_parser::mark_schema() const {
+		return {argument_order.size(),
+				positional_arguments,
+				constraints.size(),
+				on_complete_events.size(),
+				async_on_complete_events.size(),
+				schema_version,
+				{}};
+	}
+
+	void base_parser::rollback_schema(subcommand_mark &mark) {
+		for (auto index = mark.arguments; index < argument_order.size(); ++index) {
+			int const id = argument_order[index];
+			if (auto name = reverse_short_arguments.find(id); name != reverse_short_arguments.end()) {
+				short_arguments.erase(name->second);
+				reverse_short_arguments.erase(name);
+			}
+			if (auto name = reverse_long_arguments.find(id); name != reverse_long_arguments.end()) {
+				long_arguments.erase(name->second);
+				reverse_long_arguments.erase(name);
+			}
+			if (auto name = reverse_positional_names.find(id); name != reverse_positional_names.end()) {
+				positional_name_map.erase(name->second);
+				reverse_positional_names.erase(name);
+			}
+			argument_map.erase(id);
+			stored_arguments.erase(id);
+			occurrence_counts.erase(id);
+			default_factories.erase(id);
+			batched_validators.erase(id);
+			value_codecs.erase(id);
+			action_dependencies.erase(id);
+			std::lock_guard<std::mutex> lock(*defaults_mutex);
+			materialized_defaults.erase(id);
+		}
+		argument_order.resize(mark.arguments);
+		positional_arguments = std::move(mark.positional_arguments);
+		constraints.truncate(mark.constraints, mark.arguments);
+		on_complete_events.resize(mark.on_complete_events);
+		async_on_complete_events.erase(async_on_complete_events.begin() +
+										   static_cast<std::ptrdiff_t>(mark.async_on_complete_events),
+									   async_on_complete_events.end());
+<<<<<<< HEAD
+		names_indexed = false;
+||||||| parent of 9508c74 ([user-047] Cache parse results per command line in a bounded LRU)
+=======
+		schema_version = mark.schema_version;
+>>>>>>> 9508c74 ([user-047] Cache parse results per command line in a bounded LRU)
+	}
+
 	std::string
 	base_parser::build_help_text(std::initializer_list<conventions::convention const *const> convention_types) const {
 		std::stringstream ss;
-		ss << "Usage: " << program_name << " [OPTIONS]...";
+		ss << "Usage: " << program_name;
+		for (auto const &command : selected_subcommands) {
+			ss << " " << command;
+		}
+		ss << " [OPTIONS]...";
 
 		for (auto const &pos_id : positional_arguments) {
 			if (pos_id == -1)
@@ -119,6 +410,9 @@ namespace argument_parser {
 				ss << " [" << name_it->second << "]";
 			}
 		}
+		if (!subcommands.empty()) {
+			ss << " <command>";
+		}
 		ss << "\n";
 
 		size_t max_short_len = 0;
@@ -134,10 +428,11 @@ namespace argument_parser {
 			if (arg.is_positional())
 				continue;
 
-			auto short_arg =
-				reverse_short_arguments.find(id) != reverse_short_arguments.end() ? reverse_short_arguments.at(id) : "";
-			auto long_arg =
-				reverse_long_arguments.find(id) != reverse_long_arguments.end() ? reverse_long_arguments.at(id) : "";
+			std::string short_arg, long_arg;
+			if (auto name = reverse_short_arguments.find(id); name != reverse_short_arguments.end())
+				short_arg = name->second;
+			if (auto name = reverse_long_arguments.find(id); name != reverse_long_arguments.end())
+				long_arg = name->second;
 
 			std::vector<std::pair<std::string, std::string>> parts;
 			std::unordered_set<std::string> hasOnce;
@@ -158,7 +453,7 @@ namespace argument_parser {
 					parts.push_back({"", ""}); // trigger empty space in the help text
 				}
 			}
-			help_lines.push_back({parts, arg.help_text});
+			help_lines.push_back({parts, arg.get_help_text()});
 		}
 
 		if (!help_lines.empty()) {
@@ -197,91 +492,367 @@ namespace argument_parser {
 				if (name_it == reverse_positional_names.end())
 					continue;
 				auto const &arg = argument_map.at(pos_id);
-				std::string display_name = "<" + name_it->second + ">";
+				std::string display_name = "<" + std::string(name_it->second) + ">";
 				ss << "\t" << std::left << std::setw(static_cast<int>(max_pos_name_len)) << display_name << "\t"
 				   << arg.get_help_text() << "\n";
 			}
 		}
 
+		// after a selection without a further level, the level the last subcommand was selected from
+		auto const *commands = &subcommands;
+		if (commands->empty() && !subcommand_marks.empty()) {
+			commands = &subcommand_marks.back().subcommands;
+		}
+		if (!commands->empty()) {
+			ss << "\nCommands:\n";
+			size_t max_command_len = 0;
+			for (auto const &command : *commands) {
+				max_command_len = std::max(max_command_len, command.name.length());
+			}
+			for (auto const &command : *commands) {
+				ss << "\t" << std::left << std::setw(static_cast<int>(max_command_len)) << command.name << "\t"
+				   << command.help_text << "\n";
+			}
+		}
+
 		return ss.str();
 	}
 
 	argument &base_parser::get_argument(conventions::parsed_argument const &arg) {
-		if (arg.first == conventions::argument_type::LONG) {
-			auto long_pos = long_arguments.find(arg.second);
-			if (long_pos != long_arguments.end())
-				return argument_map.at(long_pos->second);
-		} else if (arg.first == conventions::argument_type::SHORT) {
-			auto short_pos = short_arguments.find(arg.second);
-			if (short_pos != short_arguments.end())
-				return argument_map.at(short_pos->second);
-		} else if (arg.first == conventions::argument_type::INTERCHANGABLE) {
+		bool const is_long = arg.first == conventions::argument_type::LONG;
+		bool const is_short = arg.first == conventions::argument_type::SHORT;
+		bool const is_interchangable = arg.first == conventions::argument_type::INTERCHANGABLE;
+
+		if (is_long || is_interchangable) {
 			auto long_pos = long_arguments.find(arg.second);
 			if (long_pos != long_arguments.end())
 				return argument_map.at(long_pos->second);
+		}
+		if (is_short || is_interchangable) {
 			auto short_pos = short_arguments.find(arg.second);
 			if (short_pos != short_arguments.end())
 				return argument_map.at(short_pos->second);
 		}
+
+		bool const ignore_case = is_interchangable || long_matching.ignore_case;
+		if ((is_long || is_interchangable) && (ignore_case || long_matching.unique_prefix)) {
+			if (!names_indexed) {
+				long_index.rebuild(long_arguments);
+				short_index.rebuild(short_arguments);
+				names_indexed = true;
+			}
+			if (auto id = find_indexed(long_index, arg.second, ignore_case, long_matching.unique_prefix)) {
+				return argument_map.at(id.value());
+			}
+			if (is_interchangable) {
+				if (auto id = find_indexed(short_index, arg.second, true, false)) {
+					return argument_map.at(id.value());
+				}
+			}
+		}
 		throw std::runtime_error("Unknown argument: " + arg.second);
 	}
 
+	std::optional<int> base_parser::find_indexed(internal::name_index const &index, std::string const &name,
+												 bool ignore_case, bool allow_prefix) const {
+		auto match = index.find(name, ignore_case, allow_prefix);
+		if (match.status == internal::name_index::match_status::unique) {
+			return match.id;
+		}
+		if (match.status == internal::name_index::match_status::ambiguous) {
+			std::string candidates;
+			for (auto const *it = match.first; it != match.last; ++it) {
+				if (internal::name_index::matches_query(*it, name, ignore_case, allow_prefix)) {
+					candidates.append(candidates.empty() ? "" : ", ").append(it->name);
+				}
+			}
+			throw std::runtime_error("Ambiguous argument: " + name + " could be any of " + candidates);
+		}
+		return std::nullopt;
+	}
+
+	void base_parser::set_long_name_matching(name_matching matching) {
+		long_matching = matching;
+	}
+
+	void base_parser::set_dry_run(bool enabled) {
+		dry_run = enabled;
+	}
+
+	void base_parser::exit_on_requirement_errors(bool enabled) {
+		exit_on_requirement_error = enabled;
+	}
+
+	void base_parser::set_parse_cache(std::size_t capacity, bool replay_actions) {
+		restored_result.reset();
+		replay_cached_actions = replay_actions;
+		if (capacity == 0) {
+			result_cache.reset();
+		} else {
+			result_cache.emplace(capacity);
+		}
+	}
+
+	parse_cache_statistics base_parser::parse_cache_stats() const {
+		return result_cache.has_value() ? result_cache->statistics() : parse_cache_statistics{};
+	}
+
+	std::uint64_t base_parser::parse_cache_key(
+		std::initializer_list<conventions::convention const *const> convention_types) const {
+		std::uint64_t salt = schema_version;
+		for (auto const *convention : convention_types) {
+			salt = (salt ^ reinterpret_cast<std::uintptr_t>(convention)) * 1099511628211ull;
+		}
+		return internal::parse_cache::key_of(parsed_arguments, salt);
+	}
+
+	bool base_parser::restore_cached_parse(std::shared_ptr<internal::parse_cache::result const> cached) {
+		for (auto const &name : cached->subcommand_path) {
+			if (!try_select_subcommand(name)) {
+				break;
+			}
+		}
+		if (selected_subcommands != cached->subcommand_path || schema_version != cached->schema_version) {
+			// the factories did not register what they registered for the cached parse
+			rollback_subcommands();
+			return false;
+		}
+
+		for (auto index : cached->invoked) {
+			auto const id = argument_order[index];
+			argument_map.at(id).set_invoked(true);
+		}
+		restored_result = std::move(cached);
+		if (!replay_cached_actions || restored_result->actions.empty()) {
+			return true;
+		}
+
+		std::vector<found_argument> replayed;
+		replayed.reserve(restored_result->actions.size());
+		for (auto const &action : restored_result->actions) {
+			replayed.push_back({action.key, &argument_map.at(argument_order[action.index]), action.value});
+		}
+		auto scope = track_phase(instrumentation::parse_phase::invoke_arguments);
+		invoke_arguments(replayed, nullptr);
+		return true;
+	}
+
+	void base_parser::remember_parse(std::uint64_t key, std::vector<found_argument> const &found_arguments) {
+		auto cached = std::make_shared<internal::parse_cache::result>();
+		cached->tokens = parsed_arguments;
+		cached->subcommand_path = selected_subcommands;
+		cached->schema_version = schema_version;
+		cached->values.reserve(stored_arguments.size());
+		for (auto const &[id, value] : stored_arguments) {
+			if (value.has_value()) {
+				cached->values.emplace_back(argument_map.at(id).index, value);
+			}
+		}
+		std::sort(cached->values.begin(), cached->values.end(),
+				  [](auto const &lhs, auto const &rhs) { return lhs.first < rhs.first; });
+
+		cached->invoked.reserve(found_arguments.size());
+		for (auto const &found : found_arguments) {
+			cached->invoked.push_back(found.arg->index);
+			if (!found.arg->is_storing()) {
+				cached->actions.push_back({found.arg->index, found.key, found.value});
+			}
+		}
+		std::sort(cached->invoked.begin(), cached->invoked.end());
+		cached->invoked.erase(std::unique(cached->invoked.begin(), cached->invoked.end()), cached->invoked.end());
+		result_cache->insert(key, std::move(cached));
+	}
+
+	void base_parser::reserve(std::size_t options, std::size_t positionals) {
+		argument_map.reserve(argument_map.size() + options + positionals);
+		argument_order.reserve(argument_order.size() + options + positionals);
+		value_codecs.reserve(value_codecs.size() + options + positionals);
+		short_arguments.reserve(short_arguments.size() + options);
+		reverse_short_arguments.reserve(reverse_short_arguments.size() + options);
+		long_arguments.reserve(long_arguments.size() + options);
+		reverse_long_arguments.reserve(reverse_long_arguments.size() + options);
+		positional_arguments.reserve(positional_arguments.size() + positionals);
+		positional_name_map.reserve(positional_name_map.size() + positionals);
+		reverse_positional_names.reserve(reverse_positional_names.size() + positionals);
+	}
+
+	std::string base_parser::image_key(int id) const {
+		if (auto name = reverse_long_arguments.find(id); name != reverse_long_arguments.end())
+			return std::string(name->second);
+		if (auto name = reverse_short_arguments.find(id); name != reverse_short_arguments.end())
+			return std::string(name->second);
+		return std::string(reverse_positional_names.at(id));
+	}
+
+	std::uint64_t base_parser::schema_hash() const {
+		std::vector<std::string> records;
+		records.reserve(argument_map.size());
+		for (auto const &[id, arg] : argument_map) {
+			auto codec = value_codecs.find(id);
+			records.push_back(image_key(id) + '\0' + std::to_string(static_cast<int>(arg.get_accumulation())) +
+							  (arg.is_storing() ? "s" : "a") + (arg.is_positional() ? "p" : "o") +
+							  (codec == value_codecs.end() ? "" : codec->second.type_name));
+		}
+		std::sort(records.begin(), records.end());
+
+		std::uint64_t hash = 14695981039346656037ull; // FNV-1a
+		for (auto const &record : records) {
+			for (unsigned char c : record) {
+				hash = (hash ^ c) * 1099511628211ull;
+			}
+			hash = (hash ^ 0xffu) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::string base_parser::save_image() const {
+		std::vector<image::entry> entries;
+		entries.reserve(argument_map.size());
+		for (auto const &[id, arg] : argument_map) {
+			image::entry e{image_key(id), arg.is_invoked(), false, {}};
+			auto codec = value_codecs.find(id);
+			auto const *stored = stored_value(id);
+			// a type the image cannot represent is recorded as invoked only
+			if (stored != nullptr && codec != value_codecs.end() && codec->second.encode != nullptr) {
+				codec->second.encode(*stored, e.value);
+				e.has_value = true;
+			}
+			entries.push_back(std::move(e));
+		}
+		std::sort(entries.begin(), entries.end(),
+				  [](image::entry const &lhs, image::entry const &rhs) { return lhs.key < rhs.key; });
+		return image::write(schema_hash(), entries);
+	}
+
+	void base_parser::load_image(std::string_view bytes) {
+		auto entries = image::read(bytes, schema_hash());
+		stored_arguments.clear();
+		restored_result.reset();
+		for (auto &[id, arg] : argument_map) {
+			arg.set_invoked(false);
+		}
+		for (auto const &e : entries) {
+			auto id = find_argument_id(std::string(e.key));
+			if (!id.has_value()) {
+				throw std::runtime_error("Parse image names an unknown argument: " + std::string(e.key));
+			}
+			argument_map.at(id.value()).set_invoked(e.invoked);
+			if (e.has_value) {
+				auto codec = value_codecs.find(id.value());
+				if (codec == value_codecs.end() || codec->second.decode == nullptr) {
+					throw std::runtime_error("Parse image holds a value " + std::string(e.key) + " cannot take");
+				}
+				stored_arguments[id.value()] = codec->second.decode(e.value);
+			}
+		}
+	}
+
 	void base_parser::enforce_creation_thread() {
 		if (std::this_thread::get_id() != this->creation_thread_id.load()) {
 			throw std::runtime_error("handle_arguments must be called from the main thread");
 		}
 	}
 
-	bool base_parser::test_conventions(std::initializer_list<conventions::convention const *const> convention_types,
-									   std::unordered_map<std::string, std::string> &values_for_arguments,
-									   std::vector<std::pair<std::string, argument>> &found_arguments,
-									   std::optional<argument> &found_help, std::vector<std::string>::iterator &it,
-									   std::stringstream &error_stream) {
+	bool base_parser::test_conventions(std::vector<found_argument> &found_arguments,
+									   argument const *&found_help, std::vector<std::string>::iterator &it,
+									   internal::diagnostics &failures) {
+		using code = internal::diagnostics::code;
+		std::string const &current_argument = *it;
+		auto const token_index = static_cast<std::size_t>(it - parsed_arguments.begin());
 
-		std::string current_argument = *it;
-
-		for (auto const &convention_type : convention_types) {
+		for (auto const &convention_type : current_conventions()) {
 			auto extracted = convention_type->get_argument(current_argument);
 			if (extracted.first == conventions::argument_type::ERROR) {
-				error_stream << "Convention \"" << convention_type->name() << "\" failed with: " << extracted.second
-							 << "\n";
+				failures.add(code::convention_rejected, token_index, *convention_type, std::move(extracted.second));
 				continue;
 			}
 
 			try {
-				argument &corresponding_argument = get_argument(extracted);
-
-				if (extracted.second == "h" || extracted.second == "help") {
-					found_help = corresponding_argument;
+				argument *corresponding_argument = resolve_token(extracted, found_arguments, found_help);
+				if (corresponding_argument == nullptr) {
 					return true;
 				}
 
-				found_arguments.emplace_back(extracted.second, corresponding_argument);
-
-				if (corresponding_argument.expects_parameter()) {
-					if (convention_type->requires_next_token() && (it + 1) == parsed_arguments.end()) {
-						throw std::runtime_error("Expected value for argument " + extracted.second);
-					}
-					values_for_arguments[extracted.second] =
-						convention_type->requires_next_token() ? *(++it) : convention_type->extract_value(*it);
+				std::string value;
+				if (corresponding_argument->expects_parameter()) {
+					value = convention_type->requires_next_token() ? next_token_value(it, extracted.second)
+																   : convention_type->extract_value(*it);
 				}
+				found_arguments.push_back({extracted.second, corresponding_argument, std::move(value), false});
 
 				return true;
 			} catch (const std::runtime_error &e) {
-				error_stream << "Convention \"" << convention_type->name() << "\" failed with: " << e.what() << "\n";
+				failures.add(code::convention_rejected, token_index, *convention_type, std::string(e.what()));
 			}
 		}
 
 		return false;
 	}
 
-	void base_parser::extract_arguments(std::initializer_list<conventions::convention const *const> convention_types,
-										std::unordered_map<std::string, std::string> &values_for_arguments,
-										std::vector<std::pair<std::string, argument>> &found_arguments,
-										std::optional<argument> &found_help) {
+	argument *base_parser::resolve_token(conventions::parsed_argument const &extracted,
+										 std::vector<found_argument> &found_arguments,
+										 argument const *&found_help) {
+		if (expand_counted_bundle(extracted, found_arguments)) {
+			return nullptr;
+		}
+
+		argument &corresponding_argument = get_argument(extracted);
+
+		// by identity, so "--HELP" or an abbreviation of --help also shows help
+		auto short_name = reverse_short_arguments.find(corresponding_argument.id);
+		auto long_name = reverse_long_arguments.find(corresponding_argument.id);
+		if ((short_name != reverse_short_arguments.end() && short_name->second == "h") ||
+			(long_name != reverse_long_arguments.end() && long_name->second == "help")) {
+			found_help = &corresponding_argument;
+			return nullptr;
+		}
+		return &corresponding_argument;
+	}
+
+	std::string base_parser::next_token_value(std::vector<std::string>::iterator &it, std::string const &name) const {
+		if ((it + 1) == parsed_arguments.end()) {
+			throw std::runtime_error("Expected value for argument " + name);
+		}
+		return *(++it);
+	}
+
+	bool base_parser::expand_counted_bundle(conventions::parsed_argument const &extracted,
+											std::vector<found_argument> &found_arguments) {
+		// "-vvv" counts as three occurrences of a counting "-v", unless "vvv" itself is registered
+		auto const &name = extracted.second;
+		if (extracted.first != conventions::argument_type::SHORT &&
+			extracted.first != conventions::argument_type::INTERCHANGABLE) {
+			return false;
+		}
+		if (name.size() < 2 || name.find_first_not_of(name[0]) != std::string::npos) {
+			return false;
+		}
+		if (contains(short_arguments, name) || contains(long_arguments, name)) {
+			return false;
+		}
+
+		auto short_pos = short_arguments.find(name.substr(0, 1));
+		if (short_pos == short_arguments.end()) {
+			return false;
+		}
+		argument &counted = argument_map.at(short_pos->second);
+		if (counted.get_accumulation() != accumulation_mode::count) {
+			return false;
+		}
+
+		for (size_t i = 0; i < name.size(); ++i) {
+			found_arguments.push_back({std::string(short_pos->first), &counted, {}, false});
+		}
+		return true;
+	}
+
+	void base_parser::extract_arguments(token_tester test_token, std::vector<found_argument> &found_arguments,
+										argument const *&found_help) {
 
 		size_t next_positional_index = 0;
 		bool force_positional = false;
+		bool selecting = true; // only the first positional token of a level may select a subcommand
+		internal::diagnostics failures; // of the current token only; reused so the success path does not allocate
 
 		for (auto it = parsed_arguments.begin(); it != parsed_arguments.end(); ++it) {
 			if (*it == "--") {
@@ -295,89 +866,367 @@ namespace argument_parser {
 				}
 				int arg_id = positional_arguments[next_positional_index];
 				argument &pos_arg = argument_map.at(arg_id);
-				std::string const &pos_name = reverse_positional_names.at(arg_id);
-				found_arguments.emplace_back(pos_name, pos_arg);
-				values_for_arguments[pos_name] = *it;
+				std::string pos_name(reverse_positional_names.at(arg_id));
+				found_arguments.push_back({std::move(pos_name), &pos_arg, *it, false});
 				next_positional_index++;
 				continue;
 			}
 
-			std::stringstream error_stream;
-
-			if (!test_conventions(convention_types, values_for_arguments, found_arguments, found_help, it,
-								  error_stream)) {
+			failures.clear();
+			if (!(this->*test_token)(found_arguments, found_help, it, failures)) {
+				if (selecting && !subcommands.empty() && try_select_subcommand(*it)) {
+					continue;
+				}
+				selecting = false;
 				if (next_positional_index < positional_arguments.size()) {
 					int arg_id = positional_arguments[next_positional_index];
 					argument &pos_arg = argument_map.at(arg_id);
-					std::string const &pos_name = reverse_positional_names.at(arg_id);
-					found_arguments.emplace_back(pos_name, pos_arg);
-					values_for_arguments[pos_name] = *it;
+					std::string pos_name(reverse_positional_names.at(arg_id));
+					found_arguments.push_back({std::move(pos_name), &pos_arg, *it, false});
 					next_positional_index++;
 				} else {
 					throw std::runtime_error("All trials for argument: \n\t\"" + *it + "\"\n failed with: \n" +
-											 error_stream.str());
+											 failures.render());
 				}
 			}
 		}
 	}
 
-	std::string replace_var(std::string text, const std::string &var_name, const std::string &value) {
-		std::string placeholder = "${" + var_name + "}";
-		size_t pos = text.find(placeholder);
+	void base_parser::invoke_arguments(std::vector<found_argument> &found_arguments,
+									   argument const *found_help) {
 
-		while (pos != std::string::npos) {
-			text.replace(pos, placeholder.length(), value);
-			pos = text.find(placeholder, pos + value.length());
+		if (found_help) {
+			if (!dry_run) {
+				found_help->action->invoke();
+			}
+			return;
 		}
-		return text;
-	}
 
-	void base_parser::invoke_arguments(std::unordered_map<std::string, std::string> const &values_for_arguments,
-									   std::vector<std::pair<std::string, argument>> &found_arguments,
-									   std::optional<argument> const &found_help) {
+		occurrence_counts.clear();
+		for (auto const &found : found_arguments) {
+			if (found.arg->get_accumulation() == accumulation_mode::append) {
+				occurrence_counts[found.arg->id]++;
+			}
+		}
 
-		if (found_help) {
-			found_help->action->invoke();
+		if (concurrent_actions) {
+			invoke_arguments_concurrently(found_arguments);
 			return;
 		}
 
-		std::stringstream error_stream;
-		for (auto &[key, value] : found_arguments) {
+		internal::diagnostics failures;
+		for (std::size_t i = 0; i < found_arguments.size(); ++i) {
+			auto &found = found_arguments[i];
 			try {
-				if (value.expects_parameter()) {
-					value.action->invoke_with_parameter(values_for_arguments.at(key));
+				invoke_found_argument(found);
+			} catch (const std::runtime_error &e) {
+				failures.add(internal::diagnostics::code::action_failed, i, found.key, std::string(e.what()));
+			}
+		}
+		validate_batches(found_arguments, failures);
+
+		if (!failures.empty()) {
+			throw std::runtime_error(failures.render());
+		}
+	}
+
+	void base_parser::validate_batches(std::vector<found_argument> const &found_arguments,
+									   internal::diagnostics &failures) {
+		if (batched_validators.empty()) {
+			return;
+		}
+		std::unordered_set<int> validated;
+		for (std::size_t i = 0; i < found_arguments.size(); ++i) {
+			auto const &found = found_arguments[i];
+			auto validator = batched_validators.find(found.arg->id);
+			if (validator == batched_validators.end() || !validated.insert(found.arg->id).second) {
+				continue;
+			}
+			auto slot = stored_arguments.find(found.arg->id);
+			if (slot == stored_arguments.end() || !slot->second.has_value()) {
+				continue;
+			}
+			auto error = validator->second(slot->second);
+			if (!error.empty()) {
+				failures.add(internal::diagnostics::code::action_failed, i, found.key, std::move(error));
+			}
+		}
+	}
+
+	void base_parser::invoke_found_argument(found_argument &found) {
+		instrumentation::trace_span span("action", found.key);
+		instrumentation::option_scope option(found.key);
+		bool accepted = true;
+		if (dry_run && !found.arg->is_storing()) {
+			if (found.arg->expects_parameter()) {
+				accepted = found.arg->action->check_parameter(found.value);
+			}
+		} else if (found.arg->expects_parameter()) {
+			accepted = found.arg->action->invoke_with_parameter(found.value);
+		} else {
+			found.arg->action->invoke();
+		}
+		// a value dropped by fail_skip leaves the option as if it was not given
+		found.skipped = !accepted;
+		if (accepted) {
+			found.arg->set_invoked(true);
+		}
+	}
+
+	void base_parser::invoke_arguments_concurrently(std::vector<found_argument> &found_arguments) {
+		// one task per option: repeated occurrences stay ordered on the same thread
+		struct action_task {
+			int id;
+			std::vector<found_argument *> occurrences;
+			std::vector<size_t> dependents;
+			size_t pending = 0;
+			bool dependency_failed = false;
+			bool failed = false;
+			internal::diagnostics errors;
+		};
+
+		std::vector<action_task> tasks;
+		std::unordered_map<int, size_t> task_of;
+		for (auto &found : found_arguments) {
+			auto [it, inserted] = task_of.emplace(found.arg->id, tasks.size());
+			if (inserted) {
+				tasks.push_back({found.arg->id, {}, {}, 0, false, false, {}});
+			}
+			tasks[it->second].occurrences.push_back(&found);
+		}
+
+		for (size_t i = 0; i < tasks.size(); ++i) {
+			auto deps = action_dependencies.find(tasks[i].id);
+			if (deps == action_dependencies.end()) {
+				continue;
+			}
+			for (auto const &dependency : deps->second) {
+				auto dep_id = find_argument_id(dependency);
+				if (!dep_id.has_value()) {
+					throw std::logic_error("Unknown action dependency: " + dependency);
+				}
+				auto dep_task = task_of.find(dep_id.value());
+				if (dep_task == task_of.end() || dep_task->second == i) {
+					continue; // absent options impose no ordering
+				}
+				tasks[dep_task->second].dependents.push_back(i);
+				tasks[i].pending++;
+			}
+		}
+
+		std::deque<size_t> ready;
+		{
+			std::vector<size_t> pending(tasks.size());
+			for (size_t i = 0; i < tasks.size(); ++i) {
+				pending[i] = tasks[i].pending;
+				if (pending[i] == 0) {
+					ready.push_back(i);
+				}
+			}
+			std::deque<size_t> order = ready;
+			size_t visited = 0;
+			for (; !order.empty(); ++visited) {
+				auto current = order.front();
+				order.pop_front();
+				for (auto dependent : tasks[current].dependents) {
+					if (--pending[dependent] == 0) {
+						order.push_back(dependent);
+					}
+				}
+			}
+			if (visited != tasks.size()) {
+				throw std::logic_error("Action dependencies contain a cycle");
+			}
+		}
+
+		// stored slots are created up front so actions only look up existing entries while running concurrently
+		for (auto const &task : tasks) {
+			stored_arguments[task.id];
+		}
+
+		std::mutex mutex;
+		std::condition_variable wake;
+		size_t remaining = tasks.size();
+		std::exception_ptr unexpected;
+		auto *recorder = trace;
+
+		auto worker = [&, recorder] {
+			instrumentation::detail::active_recorder = recorder;
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true) {
+				wake.wait(lock, [&] { return !ready.empty() || remaining == 0; });
+				if (ready.empty()) {
+					return;
+				}
+				auto &task = tasks[ready.front()];
+				ready.pop_front();
+				lock.unlock();
+
+				if (task.dependency_failed) {
+					task.failed = true;
 				} else {
-					value.action->invoke();
+					for (auto *found : task.occurrences) {
+						try {
+							invoke_found_argument(*found);
+						} catch (const std::runtime_error &e) {
+							task.failed = true;
+							task.errors.add(internal::diagnostics::code::action_failed,
+											static_cast<std::size_t>(found - found_arguments.data()), found->key,
+											std::string(e.what()));
+						} catch (...) {
+							task.failed = true;
+							std::lock_guard<std::mutex> guard(mutex);
+							if (!unexpected) {
+								unexpected = std::current_exception();
+							}
+						}
+					}
 				}
-				value.set_invoked(true);
-				argument_map.at(value.id).set_invoked(true);
-			} catch (const std::runtime_error &e) {
-				std::string err{e.what()};
-				err = replace_var(err, "KEY", "for " + key);
-				error_stream << "Error: " << err << "\n";
+
+				lock.lock();
+				remaining--;
+				for (auto dependent : task.dependents) {
+					tasks[dependent].dependency_failed |= task.failed;
+					if (--tasks[dependent].pending == 0) {
+						ready.push_back(dependent);
+					}
+				}
+				wake.notify_all();
+			}
+		};
+
+		unsigned thread_count = concurrent_action_threads != 0 ? concurrent_action_threads
+															   : std::max(1u, std::thread::hardware_concurrency());
+		thread_count = static_cast<unsigned>(std::min<size_t>(thread_count, tasks.size()));
+		std::vector<std::thread> workers;
+		for (unsigned i = 1; i < thread_count; ++i) {
+			workers.emplace_back(worker);
+		}
+		{
+			auto previous_recorder = instrumentation::detail::active_recorder;
+			worker();
+			instrumentation::detail::active_recorder = previous_recorder;
+		}
+		for (auto &thread : workers) {
+			thread.join();
+		}
+
+		if (unexpected) {
+			std::rethrow_exception(unexpected);
+		}
+
+		internal::diagnostics failures;
+		for (auto &task : tasks) {
+			failures.append(std::move(task.errors));
+			if (task.dependency_failed) {
+				auto const *first = task.occurrences.front();
+				failures.add(internal::diagnostics::code::dependency_failed,
+							 static_cast<std::size_t>(first - found_arguments.data()), first->key, std::string_view{});
 			}
 		}
+		validate_batches(found_arguments, failures);
+		if (!failures.empty()) {
+			throw std::runtime_error(failures.render());
+		}
+	}
+
+	void base_parser::set_concurrent_actions(bool enabled, unsigned max_threads) {
+		concurrent_actions = enabled;
+		concurrent_action_threads = max_threads;
+	}
+
+	void base_parser::add_action_dependencies(std::string const &arg, std::vector<std::string> const &dependencies) {
+		auto id = find_argument_id(arg);
+		if (!id.has_value()) {
+			throw std::runtime_error("Cannot add dependencies to unknown argument: " + arg);
+		}
+		auto &existing = action_dependencies[id.value()];
+		existing.insert(existing.end(), dependencies.begin(), dependencies.end());
+	}
+
+	void base_parser::add_mutually_exclusive_group(std::vector<std::string> const &names) {
+		constraints.add_group(internal::constraint_set::kind::mutually_exclusive, constraint_indices(names));
+	}
 
-		std::string error_message = error_stream.str();
-		if (!error_message.empty()) {
-			throw std::runtime_error(error_message);
+	void base_parser::add_at_least_one_group(std::vector<std::string> const &names) {
+		constraints.add_group(internal::constraint_set::kind::at_least_one, constraint_indices(names));
+	}
+
+	void base_parser::add_requirements(std::string const &arg, std::vector<std::string> const &required) {
+		constraints.add_requirement(constraint_index(arg), constraint_indices(required));
+	}
+
+	std::size_t base_parser::constraint_index(std::string const &arg) const {
+		auto id = find_argument_id(arg);
+		if (!id.has_value()) {
+			throw std::runtime_error("Cannot add a constraint on unknown argument: " + arg);
 		}
+		return argument_map.at(id.value()).index;
+	}
+
+	std::vector<std::size_t> base_parser::constraint_indices(std::vector<std::string> const &names) const {
+		std::vector<std::size_t> indices;
+		indices.reserve(names.size());
+		for (auto const &name : names) {
+			indices.push_back(constraint_index(name));
+		}
+		return indices;
 	}
 
 	void base_parser::handle_arguments(std::initializer_list<conventions::convention const *const> convention_types) {
+		handle_arguments_with(convention_types, &base_parser::test_conventions);
+	}
+
+	void base_parser::handle_arguments_with(
+		std::initializer_list<conventions::convention const *const> convention_types, token_tester test_token) {
 		enforce_creation_thread();
+		join_async_on_complete_events();
 
 		deferred_exec reset_current_conventions([this]() { this->reset_current_conventions(); });
 		this->current_conventions(convention_types);
 
-		std::unordered_map<std::string, std::string> values_for_arguments;
-		std::vector<std::pair<std::string, argument>> found_arguments;
-		std::optional<argument> found_help = std::nullopt;
+		rollback_subcommands();
+		restored_result.reset();
+		std::uint64_t cache_key = 0;
+		if (result_cache.has_value()) {
+			// each parse starts from nothing, so a hit and a miss leave the same values behind
+			stored_arguments.clear();
+			for (auto &[id, arg] : argument_map) {
+				arg.set_invoked(false);
+			}
+			cache_key = parse_cache_key(convention_types);
+			auto cached = result_cache->find(cache_key, parsed_arguments);
+			if (cached != nullptr && restore_cached_parse(std::move(cached))) {
+				if (!dry_run) {
+					auto scope = track_phase(instrumentation::parse_phase::fire_on_complete_events);
+					fire_on_complete_events();
+				}
+				return;
+			}
+		}
+
+		std::vector<found_argument> found_arguments;
+		argument const *found_help = nullptr;
 
-		extract_arguments(convention_types, values_for_arguments, found_arguments, found_help);
-		invoke_arguments(values_for_arguments, found_arguments, found_help);
-		check_for_required_arguments(convention_types);
-		fire_on_complete_events();
+		{
+			auto scope = track_phase(instrumentation::parse_phase::extract_arguments);
+			extract_arguments(test_token, found_arguments, found_help);
+		}
+		{
+			auto scope = track_phase(instrumentation::parse_phase::invoke_arguments);
+			invoke_arguments(found_arguments, found_help);
+		}
+		{
+			auto scope = track_phase(instrumentation::parse_phase::check_for_required_arguments);
+			check_for_required_arguments(convention_types, found_arguments, found_help);
+		}
+		if (result_cache.has_value() && found_help == nullptr) {
+			remember_parse(cache_key, found_arguments);
+		}
+		if (!dry_run) {
+			auto scope = track_phase(instrumentation::parse_phase::fire_on_complete_events);
+			fire_on_complete_events();
+		}
 	}
 
 	void base_parser::display_help(std::initializer_list<conventions::convention const *const> convention_types) const {
@@ -406,21 +1255,50 @@ namespace argument_parser {
 		}
 	}
 
-	void base_parser::set_argument_status(bool is_required, std::string const &help_text, argument &arg) {
+	void base_parser::set_argument_status(bool is_required, std::string const &help_text, generated_help generated,
+										  argument &arg) {
 		arg.set_required(is_required);
-		arg.set_help_text(help_text);
+		if (help_text.empty()) {
+			arg.default_help = generated;
+		} else {
+			arg.set_help_text(schema_strings->intern(help_text));
+		}
+	}
+
+	std::string_view base_parser::intern_option_name(std::string const &short_arg, std::string const &long_arg) {
+		if (!subcommand_marks.empty()) {
+			// a subcommand factory registers the same names again after every rollback
+			return schema_strings->intern(short_arg + "|" + long_arg);
+		}
+		// unique by assert_argument_not_exist, so there is nothing to deduplicate
+		return schema_strings->copy({short_arg, "|", long_arg});
 	}
 
-	void base_parser::place_argument(int id, argument const &arg, std::string const &short_arg,
+	void base_parser::place_argument(int id, argument &&arg, std::string const &short_arg,
 									 std::string const &long_arg) {
-		argument_map[id] = arg;
+		// arg.name is the interned "short|long", so both keys can view into it
+		std::string_view const name = arg.name;
+		index_argument(id, arg);
+		argument_map.insert_or_assign(id, std::move(arg));
+		names_indexed = false;
 		if (short_arg != "-") {
-			short_arguments[short_arg] = id;
-			reverse_short_arguments[id] = short_arg;
+			auto const key = name.substr(0, short_arg.size());
+			short_arguments[key] = id;
+			reverse_short_arguments[id] = key;
 		}
 		if (long_arg != "-") {
-			long_arguments[long_arg] = id;
-			reverse_long_arguments[id] = long_arg;
+			auto const key = name.substr(short_arg.size() + 1);
+			long_arguments[key] = id;
+			reverse_long_arguments[id] = key;
+		}
+	}
+
+	void base_parser::index_argument(int id, argument &arg) {
+		arg.index = argument_order.size();
+		argument_order.push_back(id);
+		++schema_version;
+		if (arg.is_required()) {
+			constraints.require(arg.index);
 		}
 	}
 
@@ -430,11 +1308,11 @@ namespace argument_parser {
 		}
 	}
 
-	void base_parser::place_positional_argument(int id, argument const &arg, std::string const &name,
-												std::optional<int> position) {
-		argument_map[id] = arg;
-		positional_name_map[name] = id;
-		reverse_positional_names[id] = name;
+	void base_parser::place_positional_argument(int id, argument &&arg, std::optional<int> position) {
+		positional_name_map[arg.name] = id;
+		reverse_positional_names[id] = arg.name;
+		index_argument(id, arg);
+		argument_map.insert_or_assign(id, std::move(arg));
 
 		if (position.has_value()) {
 			auto idx = static_cast<size_t>(position.value());
@@ -470,64 +1348,218 @@ namespace argument_parser {
 		return res;
 	}
 
+	std::string base_parser::describe_argument(std::size_t index) const {
+		auto const id = argument_order.at(index);
+		if (auto name = reverse_positional_names.find(id); name != reverse_positional_names.end()) {
+			return "<" + std::string(name->second) + ">";
+		}
+		auto short_name = reverse_short_arguments.find(id);
+		auto long_name = reverse_long_arguments.find(id);
+		return get_one_name(short_name != reverse_short_arguments.end() ? std::string(short_name->second) : "-",
+							long_name != reverse_long_arguments.end() ? std::string(long_name->second) : "-");
+	}
+
+	std::string base_parser::describe_constraint(std::size_t constraint) const {
+		using kind = internal::constraint_set::kind;
+		auto const type = constraints.type_of(constraint);
+
+		std::string members;
+		for (auto index : constraints.members_of(constraint)) {
+			if (type == kind::requires_all && seen_arguments.test(index)) {
+				continue; // only the missing requirements are reported
+			}
+			members += members.empty() ? "[" : " | ";
+			members += describe_argument(index);
+		}
+		members += "]";
+
+		switch (type) {
+		case kind::mutually_exclusive:
+			return members + ": at most one of these may be provided";
+		case kind::at_least_one:
+			return members + ": at least one of these must be provided";
+		case kind::requires_all:
+			return describe_argument(constraints.subject_of(constraint)) + ": also requires " + members;
+		}
+		return members;
+	}
+
 	void base_parser::check_for_required_arguments(
-		std::initializer_list<conventions::convention const *const> convention_types) {
-		std::vector<std::tuple<std::string, std::string, bool, bool>> required_args;
-		for (auto const &[key, arg] : argument_map) {
-			if (arg.is_required() && !arg.is_invoked()) {
-				if (arg.is_positional()) {
-					auto pos_name = reverse_positional_names.find(key) != reverse_positional_names.end()
-										? reverse_positional_names.at(key)
-										: "unknown";
-					required_args.emplace_back(pos_name, "", true, true);
-				} else {
-					auto short_arg = reverse_short_arguments.find(key) != reverse_short_arguments.end()
-										 ? reverse_short_arguments.at(key)
-										 : "-";
-					auto long_arg = reverse_long_arguments.find(key) != reverse_long_arguments.end()
-										? reverse_long_arguments.at(key)
-										: "-";
-					required_args.emplace_back(short_arg, long_arg, arg.expects_parameter(), false);
+		std::initializer_list<conventions::convention const *const> convention_types,
+		std::vector<found_argument> const &found_arguments, argument const *found_help) {
+		seen_arguments.clear();
+		if (found_help == nullptr) { // showing help invokes nothing else
+			for (auto const &found : found_arguments) {
+				if (!found.skipped) {
+					seen_arguments.set(found.arg->index);
 				}
 			}
 		}
 
-		if (!required_args.empty()) {
-			std::cerr << "These arguments were expected but not provided: \n";
-			for (auto const &[s, l, p, is_pos] : required_args) {
-				if (is_pos) {
-					std::cerr << "\t<" << s << ">: positional argument must be provided\n";
-				} else {
-					std::cerr << "\t" << get_one_name(s, l) << ": must be provided as one of [";
-					for (auto it = convention_types.begin(); it != convention_types.end(); ++it) {
-						auto generatedParts = (*it)->make_help_text(s, l, p);
-						std::string help_str = generatedParts.first;
-						if (!generatedParts.first.empty() && !generatedParts.second.empty()) {
-							help_str += "  ";
-						}
-						help_str += generatedParts.second;
+		std::vector<std::size_t> missing;
+		std::vector<std::size_t> violated;
+		constraints.missing_required(seen_arguments, missing);
+		constraints.check(seen_arguments, violated);
+		if (missing.empty() && violated.empty()) {
+			return;
+		}
 
-						size_t last_not_space = help_str.find_last_not_of(" \t");
-						if (last_not_space != std::string::npos) {
-							help_str.erase(last_not_space + 1);
-						}
-						std::cerr << help_str;
-						if (it + 1 != convention_types.end()) {
-							std::cerr << ", ";
-						}
-					}
-					std::cerr << "]\n";
+		std::ostringstream report;
+		std::vector<std::string> missing_names;
+		missing_names.reserve(missing.size());
+		if (!missing.empty()) {
+			report << "These arguments were expected but not provided: \n";
+		}
+		for (auto index : missing) {
+			missing_names.push_back(describe_argument(index));
+			auto const id = argument_order[index];
+			auto const &arg = argument_map.at(id);
+			if (arg.is_positional()) {
+				report << "\t" << missing_names.back() << ": positional argument must be provided\n";
+				continue;
+			}
+
+			std::string_view s = reverse_short_arguments.find(id) != reverse_short_arguments.end()
+									 ? reverse_short_arguments.at(id)
+									 : "-";
+			std::string_view l = reverse_long_arguments.find(id) != reverse_long_arguments.end()
+									 ? reverse_long_arguments.at(id)
+									 : "-";
+			report << "\t" << missing_names.back() << ": must be provided as one of [";
+			for (auto it = convention_types.begin(); it != convention_types.end(); ++it) {
+				auto generatedParts = (*it)->make_help_text(std::string(s), std::string(l), arg.expects_parameter());
+				std::string help_str = generatedParts.first;
+				if (!generatedParts.first.empty() && !generatedParts.second.empty()) {
+					help_str += "  ";
+				}
+				help_str += generatedParts.second;
+
+				size_t last_not_space = help_str.find_last_not_of(" \t");
+				if (last_not_space != std::string::npos) {
+					help_str.erase(last_not_space + 1);
+				}
+				report << help_str;
+				if (it + 1 != convention_types.end()) {
+					report << ", ";
 				}
 			}
-			std::cerr << "\n";
+			report << "]\n";
+		}
+
+		if (!violated.empty()) {
+			report << "These arguments cannot be combined this way: \n";
+		}
+		for (auto constraint : violated) {
+			report << "\t" << describe_constraint(constraint) << "\n";
+		}
+
+		if (exit_on_requirement_error && !dry_run) {
+			std::cerr << report.str() << "\n";
 			display_help(convention_types);
 			std::exit(1);
 		}
+		throw requirement_error(report.str(), std::move(missing), std::move(missing_names), std::move(violated));
+	}
+
+	void base_parser::set_allocation_tracker(instrumentation::allocation_tracker *tracker) {
+		tracked_allocations = tracker;
+	}
+
+	void base_parser::set_trace_recorder(instrumentation::trace_recorder *recorder) {
+		trace = recorder;
+	}
+
+	std::vector<instrumentation::table_footprint> base_parser::footprint() const {
+		auto const action_bytes = sizeof(non_parametered_action); // handlers up to four pointers are stored inline
+		auto argument_bytes = [action_bytes](argument const & /*arg*/) {
+			return action_bytes; // name and help text live in schema_strings
+		};
+
+		std::vector<instrumentation::table_footprint> tables;
+		tables.push_back({"stored_arguments", stored_arguments.size(), map_bytes(stored_arguments)});
+		tables.push_back({"long_index", long_index.size(), long_index.bytes()});
+		tables.push_back({"short_index", short_index.size(), short_index.bytes()});
+		tables.push_back({"default_factories", default_factories.size(), map_bytes(default_factories)});
+		tables.push_back({"batched_validators", batched_validators.size(), map_bytes(batched_validators)});
+		tables.push_back({"value_codecs", value_codecs.size(), map_bytes(value_codecs)});
+		tables.push_back({"materialized_defaults", materialized_defaults.size(), map_bytes(materialized_defaults)});
+		tables.push_back({"occurrence_counts", occurrence_counts.size(), map_bytes(occurrence_counts)});
+		tables.push_back({"argument_map", argument_map.size(), map_bytes(argument_map, argument_bytes)});
+		tables.push_back({"schema_strings", schema_strings->size(), schema_strings->bytes()});
+		tables.push_back({"short_arguments", short_arguments.size(), map_bytes(short_arguments)});
+		tables.push_back(
+			{"reverse_short_arguments", reverse_short_arguments.size(), map_bytes(reverse_short_arguments)});
+		tables.push_back({"long_arguments", long_arguments.size(), map_bytes(long_arguments)});
+		tables.push_back({"reverse_long_arguments", reverse_long_arguments.size(), map_bytes(reverse_long_arguments)});
+		tables.push_back({"positional_arguments", positional_arguments.size(),
+						  sizeof(positional_arguments) + positional_arguments.capacity() * sizeof(int)});
+		tables.push_back({"positional_name_map", positional_name_map.size(), map_bytes(positional_name_map)});
+		tables.push_back(
+			{"reverse_positional_names", reverse_positional_names.size(), map_bytes(reverse_positional_names)});
+		tables.push_back({"argument_order", argument_order.size(),
+						  sizeof(argument_order) + argument_order.capacity() * sizeof(int)});
+		tables.push_back({"constraints", constraints.size(), constraints.bytes()});
+		if (result_cache.has_value()) {
+			tables.push_back({"parse_cache", result_cache->statistics().entries, result_cache->bytes()});
+		}
+		std::size_t subcommand_count = subcommands.size();
+		std::size_t subcommand_bytes = sizeof(subcommands) + subcommands.capacity() * sizeof(subcommand_entry) +
+									   subcommand_marks.capacity() * sizeof(subcommand_mark);
+		for (auto const &command : subcommands) {
+			subcommand_bytes += heap_bytes(command.name) + heap_bytes(command.help_text);
+		}
+		for (auto const &mark : subcommand_marks) {
+			subcommand_count += mark.subcommands.size();
+			subcommand_bytes += mark.subcommands.capacity() * sizeof(subcommand_entry) +
+								mark.positional_arguments.capacity() * sizeof(int);
+			for (auto const &command : mark.subcommands) {
+				subcommand_bytes += heap_bytes(command.name) + heap_bytes(command.help_text);
+			}
+		}
+		tables.push_back({"subcommands", subcommand_count, subcommand_bytes});
+		tables.push_back({"on_complete_events", on_complete_events.size(),
+						  sizeof(on_complete_events) +
+							  on_complete_events.size() * (2 * sizeof(void *) + sizeof(on_complete_events.front()))});
+		std::size_t async_bytes = sizeof(async_on_complete_events) +
+								  async_on_complete_events.capacity() * sizeof(async_on_complete_event);
+		for (auto const &event : async_on_complete_events) {
+			async_bytes += heap_bytes(event.name) + event.after.capacity() * sizeof(std::size_t);
+		}
+		tables.push_back({"async_on_complete_events", async_on_complete_events.size(), async_bytes});
+
+		std::size_t parsed_bytes = sizeof(parsed_arguments) + parsed_arguments.capacity() * sizeof(std::string);
+		for (auto const &token : parsed_arguments) {
+			parsed_bytes += heap_bytes(token);
+		}
+		tables.push_back({"parsed_arguments", parsed_arguments.size(), parsed_bytes});
+		return tables;
 	}
 
-	void base_parser::fire_on_complete_events() const {
+	void base_parser::fire_on_complete_events() {
 		for (auto const &event : on_complete_events) {
+			instrumentation::trace_span span("on_complete", "on_complete");
 			event(*this);
 		}
+
+		// registration order is a topological order: predecessors must be registered first
+		for (auto &event : async_on_complete_events) {
+			std::vector<std::shared_future<void>> predecessors;
+			predecessors.reserve(event.after.size());
+			for (auto index : event.after) {
+				predecessors.push_back(async_on_complete_events[index].done);
+			}
+			// the task owns copies so later registrations may reallocate the table while it runs
+			event.done = std::async(std::launch::async,
+									[this, name = event.name, handler = event.handler,
+									 predecessors = std::move(predecessors), recorder = trace] {
+										for (auto const &predecessor : predecessors) {
+											predecessor.get();
+										}
+										instrumentation::detail::active_recorder = recorder;
+										instrumentation::trace_span span("on_complete", name);
+										handler(*this);
+									})
+							 .share();
+		}
 	}
 } // namespace argument_parser
@@ -0,0 +1,163 @@
+#include "constraints.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+	constexpr std::size_t word_bits = 64;
+
+	constexpr std::uint64_t bit_of(std::size_t index) noexcept {
+		return std::uint64_t{1} << (index % word_bits);
+	}
+} // namespace
+
+namespace argument_parser::internal {
+	void option_bits::set(std::size_t index) {
+		auto const word_index = index / word_bits;
+		if (word_index >= words.size()) {
+			words.resize(word_index + 1, 0);
+		}
+		words[word_index] |= bit_of(index);
+	}
+
+	void option_bits::clear() noexcept {
+		std::fill(words.begin(), words.end(), 0);
+	}
+
+	bool option_bits::test(std::size_t index) const noexcept {
+		return (word(index / word_bits) & bit_of(index)) != 0;
+	}
+
+	std::uint64_t option_bits::word(std::size_t word_index) const noexcept {
+		return word_index < words.size() ? words[word_index] : 0;
+	}
+
+	std::size_t option_bits::word_count() const noexcept {
+		return words.size();
+	}
+
+	void constraint_set::require(std::size_t index) {
+		auto const word_index = index / word_bits;
+		if (word_index >= required.size()) {
+			required.resize(word_index + 1, 0);
+		}
+		required[word_index] |= bit_of(index);
+	}
+
+	void constraint_set::add_group(kind type, std::vector<std::size_t> const &members) {
+		if (type == kind::requires_all) {
+			throw std::logic_error("A requirement needs a subject; use add_requirement");
+		}
+		add(type, 0, members);
+	}
+
+	void constraint_set::add_requirement(std::size_t subject, std::vector<std::size_t> const &members) {
+		add(kind::requires_all, subject, members);
+	}
+
+	void constraint_set::truncate(std::size_t constraint_count, std::size_t indices) {
+		if (constraint_count < constraints.size()) {
+			terms.resize(constraints[constraint_count].first_term);
+			constraints.resize(constraint_count);
+		}
+		for (std::size_t w = indices / word_bits; w < required.size(); ++w) {
+			auto const first_dropped = w == indices / word_bits ? indices % word_bits : 0;
+			required[w] &= (std::uint64_t{1} << first_dropped) - 1;
+		}
+	}
+
+	void constraint_set::add(kind type, std::size_t subject, std::vector<std::size_t> const &members) {
+		auto sorted = members;
+		std::sort(sorted.begin(), sorted.end());
+
+		auto const first = static_cast<std::uint32_t>(terms.size());
+		for (auto index : sorted) {
+			auto const word_index = static_cast<std::uint32_t>(index / word_bits);
+			if (terms.size() == first || terms.back().word != word_index) {
+				terms.push_back({word_index, 0});
+			}
+			terms.back().bits |= bit_of(index);
+		}
+		constraints.push_back({type, subject, first, static_cast<std::uint32_t>(terms.size())});
+	}
+
+	void constraint_set::missing_required(option_bits const &seen, std::vector<std::size_t> &missing) const {
+		for (std::size_t w = 0; w < required.size(); ++w) {
+			for (auto bits = required[w] & ~seen.word(w); bits != 0; bits &= bits - 1) {
+				std::size_t bit = 0;
+				while ((bits & (std::uint64_t{1} << bit)) == 0) {
+					++bit;
+				}
+				missing.push_back(w * word_bits + bit);
+			}
+		}
+	}
+
+	void constraint_set::check(option_bits const &seen, std::vector<std::size_t> &violated) const {
+		for (std::size_t c = 0; c < constraints.size(); ++c) {
+			auto const &rule = constraints[c];
+			bool satisfied = true;
+			switch (rule.type) {
+			case kind::mutually_exclusive: {
+				bool any = false;
+				for (auto t = rule.first_term; t < rule.last_term && satisfied; ++t) {
+					auto const present = seen.word(terms[t].word) & terms[t].bits;
+					if (present == 0) {
+						continue;
+					}
+					// a second member, either in this word or in an earlier one
+					satisfied = !any && (present & (present - 1)) == 0;
+					any = true;
+				}
+				break;
+			}
+			case kind::at_least_one:
+				satisfied = false;
+				for (auto t = rule.first_term; t < rule.last_term && !satisfied; ++t) {
+					satisfied = (seen.word(terms[t].word) & terms[t].bits) != 0;
+				}
+				break;
+			case kind::requires_all:
+				if (seen.test(rule.subject)) {
+					for (auto t = rule.first_term; t < rule.last_term && satisfied; ++t) {
+						satisfied = (seen.word(terms[t].word) & terms[t].bits) == terms[t].bits;
+					}
+				}
+				break;
+			}
+			if (!satisfied) {
+				violated.push_back(c);
+			}
+		}
+	}
+
+	constraint_set::kind constraint_set::type_of(std::size_t constraint) const {
+		return constraints.at(constraint).type;
+	}
+
+	std::size_t constraint_set::subject_of(std::size_t constraint) const {
+		return constraints.at(constraint).subject;
+	}
+
+	std::vector<std::size_t> constraint_set::members_of(std::size_t constraint) const {
+		auto const &rule = constraints.at(constraint);
+		std::vector<std::size_t> members;
+		for (auto t = rule.first_term; t < rule.last_term; ++t) {
+			for (std::size_t bit = 0; bit < word_bits; ++bit) {
+				if (terms[t].bits & (std::uint64_t{1} << bit)) {
+					members.push_back(std::size_t{terms[t].word} * word_bits + bit);
+				}
+			}
+		}
+		return members;
+	}
+
+	std::size_t constraint_set::size() const noexcept {
+		return constraints.size();
+	}
+
+	std::size_t constraint_set::bytes() const noexcept {
+		return sizeof(*this) + required.capacity() * sizeof(std::uint64_t) +
+			   constraints.capacity() * sizeof(constraint) + terms.capacity() * sizeof(term);
+	}
+} // namespace argument_parser::internal
@@ -0,0 +1,64 @@
+#include "diagnostics.hpp"
+
+#include <iterator>
+
+namespace {
+	std::string replace_var(std::string text, const std::string &var_name, const std::string &value) {
+		std::string placeholder = "${" + var_name + "}";
+		size_t pos = text.find(placeholder);
+
+		while (pos != std::string::npos) {
+			text.replace(pos, placeholder.length(), value);
+			pos = text.find(placeholder, pos + value.length());
+		}
+		return text;
+	}
+} // namespace
+
+namespace argument_parser::internal {
+	void diagnostics::add(code what, std::size_t index, std::string_view subject, std::string_view text) {
+		entries.push_back({what, index, nullptr, subject, text, {}});
+	}
+
+	void diagnostics::add(code what, std::size_t index, std::string_view subject, std::string text) {
+		entries.push_back({what, index, nullptr, subject, {}, std::move(text)});
+	}
+
+	void diagnostics::add(code what, std::size_t index, conventions::convention const &convention, std::string text) {
+		entries.push_back({what, index, &convention, {}, {}, std::move(text)});
+	}
+
+	void diagnostics::append(diagnostics &&other) {
+		entries.insert(entries.end(), std::make_move_iterator(other.entries.begin()),
+					   std::make_move_iterator(other.entries.end()));
+		other.clear();
+	}
+
+	void diagnostics::clear() noexcept {
+		entries.clear();
+	}
+
+	bool diagnostics::empty() const noexcept {
+		return entries.empty();
+	}
+
+	std::string diagnostics::render() const {
+		std::string report;
+		for (auto const &e : entries) {
+			std::string const subject = e.convention != nullptr ? e.convention->name() : std::string(e.subject);
+			std::string const text = e.owned_text.empty() ? std::string(e.text) : e.owned_text;
+			switch (e.what) {
+			case code::convention_rejected:
+				report += "Convention \"" + subject + "\" failed with: " + text + "\n";
+				break;
+			case code::action_failed:
+				report += "Error: " + replace_var(text, "KEY", "for " + subject) + "\n";
+				break;
+			case code::dependency_failed:
+				report += "Error: skipped " + subject + " because an action it depends on failed\n";
+				break;
+			}
+		}
+		return report;
+	}
+} // namespace argument_parser::internal
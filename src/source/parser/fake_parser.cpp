@@ -39,7 +39,7 @@ namespace argument_parser {
 			: fake_parser(program_name, std::vector<std::string>(arguments)) {}
 
 		void fake_parser::set_program_name(std::string const &program_name) {
-			set_program_name(program_name);
+			v2::base_parser::set_program_name(program_name);
 		}
 
 		void fake_parser::set_parsed_arguments(std::vector<std::string> const &parsed_arguments) {
@@ -0,0 +1,163 @@
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace {
+	std::uint64_t to_ns(std::chrono::steady_clock::duration d) {
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+	}
+
+	std::uint32_t current_thread_index() {
+		static std::atomic<std::uint32_t> next_index{1};
+		thread_local std::uint32_t index = next_index.fetch_add(1);
+		return index;
+	}
+
+	void write_json_string(std::ostream &os, std::string const &s) {
+		os << '"';
+		for (char c : s) {
+			switch (c) {
+			case '"':
+				os << "\\\"";
+				break;
+			case '\\':
+				os << "\\\\";
+				break;
+			case '\n':
+				os << "\\n";
+				break;
+			case '\t':
+				os << "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec
+					   << std::setfill(' ');
+				} else {
+					os << c;
+				}
+			}
+		}
+		os << '"';
+	}
+} // namespace
+
+namespace argument_parser::instrumentation {
+	const char *phase_name(parse_phase phase) noexcept {
+		switch (phase) {
+		case parse_phase::registration:
+			return "registration";
+		case parse_phase::extract_arguments:
+			return "extract_arguments";
+		case parse_phase::invoke_arguments:
+			return "invoke_arguments";
+		case parse_phase::check_for_required_arguments:
+			return "check_for_required_arguments";
+		case parse_phase::fire_on_complete_events:
+			return "fire_on_complete_events";
+		}
+		return "unknown";
+	}
+
+	void allocation_tracker::record(parse_phase phase, std::size_t bytes) noexcept {
+		auto &counter = counters[static_cast<std::size_t>(phase)];
+		counter.allocations++;
+		counter.bytes += bytes;
+	}
+
+	allocation_counter const &allocation_tracker::at(parse_phase phase) const noexcept {
+		return counters[static_cast<std::size_t>(phase)];
+	}
+
+	allocation_counter allocation_tracker::total() const noexcept {
+		allocation_counter result;
+		for (auto const &counter : counters) {
+			result.allocations += counter.allocations;
+			result.bytes += counter.bytes;
+		}
+		return result;
+	}
+
+	void allocation_tracker::reset() noexcept {
+		counters = {};
+	}
+
+	std::string allocation_tracker::report() const {
+		std::stringstream ss;
+		for (std::size_t i = 0; i < phase_count; ++i) {
+			ss << phase_name(static_cast<parse_phase>(i)) << ": " << counters[i].allocations << " allocations, "
+			   << counters[i].bytes << " bytes\n";
+		}
+		auto sum = total();
+		ss << "total: " << sum.allocations << " allocations, " << sum.bytes << " bytes\n";
+		return ss.str();
+	}
+
+	trace_recorder::trace_recorder() : epoch(clock::now()) {}
+
+	void trace_recorder::record(std::string_view name, const char *category, clock::time_point start,
+								clock::time_point end) {
+		trace_event event{std::string(name), category, to_ns(start - epoch), to_ns(end - start),
+						  current_thread_index()};
+		std::lock_guard<std::mutex> lock(recorded_mutex);
+		recorded.push_back(std::move(event));
+	}
+
+	std::vector<trace_event> trace_recorder::events() const {
+		std::lock_guard<std::mutex> lock(recorded_mutex);
+		return recorded;
+	}
+
+	void trace_recorder::clear() noexcept {
+		std::lock_guard<std::mutex> lock(recorded_mutex);
+		recorded.clear();
+	}
+
+	std::string trace_recorder::to_chrome_trace() const {
+		std::lock_guard<std::mutex> lock(recorded_mutex);
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(3);
+		ss << "{\"traceEvents\":[";
+		for (std::size_t i = 0; i < recorded.size(); ++i) {
+			auto const &event = recorded[i];
+			if (i > 0) {
+				ss << ',';
+			}
+			ss << "\n{\"name\":";
+			write_json_string(ss, event.name);
+			ss << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":" << event.start_ns / 1000.0
+			   << ",\"dur\":" << event.duration_ns / 1000.0 << ",\"pid\":1,\"tid\":" << event.thread << "}";
+		}
+		ss << "\n],\"displayTimeUnit\":\"ns\"}\n";
+		return ss.str();
+	}
+
+	std::string trace_recorder::summary() const {
+		struct aggregate {
+			std::size_t count = 0;
+			std::uint64_t total_ns = 0;
+			std::uint64_t max_ns = 0;
+		};
+
+		std::lock_guard<std::mutex> lock(recorded_mutex);
+		std::map<std::pair<std::string, std::string>, aggregate> grouped;
+		for (auto const &event : recorded) {
+			auto &entry = grouped[{event.category, event.name}];
+			entry.count++;
+			entry.total_ns += event.duration_ns;
+			entry.max_ns = std::max(entry.max_ns, event.duration_ns);
+		}
+
+		std::stringstream ss;
+		for (auto const &[key, entry] : grouped) {
+			ss << key.first << " " << key.second << ": " << entry.count << " calls, total " << entry.total_ns
+			   << " ns, max " << entry.max_ns << " ns\n";
+		}
+		return ss.str();
+	}
+} // namespace argument_parser::instrumentation
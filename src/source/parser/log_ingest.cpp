@@ -0,0 +1,398 @@
+#include "log_ingest.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <exception>
+#include <fake_parser.hpp>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	using argument_parser::ingest::cell;
+	using argument_parser::ingest::column_kind;
+	using argument_parser::ingest::schema;
+	using convention_list = std::initializer_list<argument_parser::conventions::convention const *const>;
+
+	struct row_group {
+		std::size_t rows = 0;
+		std::size_t errors = 0;
+		std::vector<std::vector<cell>> columns; // the error column last
+	};
+
+	// every chunk but the last ends right after a delimiter, so no record spans two chunks
+	std::vector<std::string_view> split_chunks(std::string_view data, char delimiter, std::size_t chunk_bytes) {
+		std::vector<std::string_view> chunks;
+		while (!data.empty()) {
+			auto end = data.size() <= chunk_bytes ? std::string_view::npos : data.find(delimiter, chunk_bytes);
+			auto size = end == std::string_view::npos ? data.size() : end + 1;
+			chunks.push_back(data.substr(0, size));
+			data.remove_prefix(size);
+		}
+		return chunks;
+	}
+
+	std::vector<std::string> tokenize(std::string_view record) {
+		std::vector<std::string> tokens;
+		constexpr std::string_view blanks = " \t\r";
+		for (auto start = record.find_first_not_of(blanks); start != std::string_view::npos;) {
+			auto end = record.find_first_of(blanks, start);
+			tokens.emplace_back(record.substr(start, end - start));
+			start = end == std::string_view::npos ? end : record.find_first_not_of(blanks, end);
+		}
+		return tokens;
+	}
+
+	void parse_record(std::string_view record, schema const &options, convention_list convention_types,
+					  row_group &group) {
+		auto const &columns = options.output_columns();
+		auto tokens = tokenize(record);
+		std::string program = tokens.empty() ? std::string{} : std::move(tokens.front());
+		if (!tokens.empty()) {
+			tokens.erase(tokens.begin());
+		}
+
+		// a throwing schema is not the record's fault, so it stops the ingest instead of becoming a row
+		argument_parser::v2::fake_parser parser(program, std::move(tokens));
+		parser.set_dry_run(true);
+		options.register_options(parser);
+
+		std::size_t filled = 0;
+		try {
+			parser.handle_arguments(convention_types);
+			for (; filled < columns.size(); ++filled) {
+				group.columns[filled].push_back(columns[filled].read(parser));
+			}
+			group.columns.back().emplace_back(std::monostate{});
+		} catch (std::exception const &e) {
+			for (; filled < columns.size(); ++filled) {
+				group.columns[filled].emplace_back(std::monostate{});
+			}
+			group.columns.back().emplace_back(std::string(e.what()));
+			group.errors++;
+		}
+		group.rows++;
+	}
+
+	row_group parse_chunk(std::string_view chunk, char delimiter, schema const &options,
+						  convention_list convention_types) {
+		row_group group;
+		group.columns.resize(options.output_columns().size() + 1);
+		while (!chunk.empty()) {
+			auto end = chunk.find(delimiter);
+			parse_record(chunk.substr(0, end), options, convention_types, group);
+			chunk.remove_prefix(end == std::string_view::npos ? chunk.size() : end + 1);
+		}
+		return group;
+	}
+
+	void write_csv_field(std::ostream &output, std::string_view text) {
+		if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+			output << text;
+			return;
+		}
+		output << '"';
+		for (char c : text) {
+			output << c;
+			if (c == '"') {
+				output << '"';
+			}
+		}
+		output << '"';
+	}
+
+	void write_csv_cell(std::ostream &output, cell const &value) {
+		if (auto const *integer = std::get_if<std::int64_t>(&value)) {
+			output << *integer;
+		} else if (auto const *real = std::get_if<double>(&value)) {
+			char buffer[32];
+			auto result = std::to_chars(std::begin(buffer), std::end(buffer), *real);
+			output.write(buffer, result.ptr - buffer);
+		} else if (auto const *boolean = std::get_if<bool>(&value)) {
+			output << (*boolean ? "true" : "false");
+		} else if (auto const *text = std::get_if<std::string>(&value)) {
+			write_csv_field(output, *text);
+		}
+	}
+
+	template <typename T> void put(std::ostream &output, T const &value) {
+		output.write(reinterpret_cast<char const *>(&value), sizeof(T));
+	}
+
+	void write_binary_column(std::ostream &output, column_kind kind, std::vector<cell> const &values) {
+		for (auto const &value : values) {
+			put<std::uint8_t>(output, std::holds_alternative<std::monostate>(value) ? 0 : 1);
+		}
+		for (auto const &value : values) {
+			switch (kind) {
+			case column_kind::integer: {
+				auto const *integer = std::get_if<std::int64_t>(&value);
+				put<std::int64_t>(output, integer ? *integer : 0);
+				break;
+			}
+			case column_kind::real: {
+				auto const *real = std::get_if<double>(&value);
+				put<double>(output, real ? *real : 0.0);
+				break;
+			}
+			case column_kind::boolean: {
+				auto const *boolean = std::get_if<bool>(&value);
+				put<std::uint8_t>(output, boolean && *boolean ? 1 : 0);
+				break;
+			}
+			case column_kind::text: {
+				auto const *text = std::get_if<std::string>(&value);
+				put<std::uint32_t>(output, text ? static_cast<std::uint32_t>(text->size()) : 0);
+				break;
+			}
+			}
+		}
+		if (kind == column_kind::text) {
+			for (auto const &value : values) {
+				if (auto const *text = std::get_if<std::string>(&value)) {
+					output.write(text->data(), static_cast<std::streamsize>(text->size()));
+				}
+			}
+		}
+	}
+
+	class table_writer {
+	public:
+		table_writer(std::ostream &output, schema const &options, argument_parser::ingest::output_format format)
+			: output(output), format(format) {
+			for (auto const &column : options.output_columns()) {
+				kinds.push_back(column.kind);
+				names.push_back(column.name);
+			}
+			kinds.push_back(column_kind::text);
+			names.emplace_back("error");
+		}
+
+		void write_header() {
+			if (format == argument_parser::ingest::output_format::csv) {
+				for (std::size_t i = 0; i < names.size(); ++i) {
+					output << (i == 0 ? "" : ",");
+					write_csv_field(output, names[i]);
+				}
+				output << '\n';
+				return;
+			}
+			output.write("APCOLS01", 8);
+			put<std::uint32_t>(output, static_cast<std::uint32_t>(names.size()));
+			for (std::size_t i = 0; i < names.size(); ++i) {
+				put<std::uint8_t>(output, static_cast<std::uint8_t>(kinds[i]));
+				put<std::uint32_t>(output, static_cast<std::uint32_t>(names[i].size()));
+				output.write(names[i].data(), static_cast<std::streamsize>(names[i].size()));
+			}
+		}
+
+		void write(row_group const &group) {
+			if (format == argument_parser::ingest::output_format::csv) {
+				for (std::size_t row = 0; row < group.rows; ++row) {
+					for (std::size_t column = 0; column < group.columns.size(); ++column) {
+						output << (column == 0 ? "" : ",");
+						write_csv_cell(output, group.columns[column][row]);
+					}
+					output << '\n';
+				}
+				return;
+			}
+			if (group.rows == 0) {
+				return;
+			}
+			put<std::uint64_t>(output, group.rows);
+			for (std::size_t column = 0; column < group.columns.size(); ++column) {
+				write_binary_column(output, kinds[column], group.columns[column]);
+			}
+		}
+
+	private:
+		std::ostream &output;
+		argument_parser::ingest::output_format format;
+		std::vector<column_kind> kinds;
+		std::vector<std::string> names;
+	};
+
+	// joins the pool on every way out of ingest; stop() first releases workers waiting for the writer to catch up
+	class pool_joiner {
+	public:
+		pool_joiner(std::vector<std::thread> &pool, std::function<void()> stop) : pool(pool), stop(std::move(stop)) {}
+
+		~pool_joiner() {
+			stop();
+			for (auto &thread : pool) {
+				thread.join();
+			}
+		}
+
+		pool_joiner(pool_joiner const &) = delete;
+		pool_joiner &operator=(pool_joiner const &) = delete;
+
+	private:
+		std::vector<std::thread> &pool;
+		std::function<void()> stop;
+	};
+
+	std::string read_whole_file(std::string const &path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			throw std::runtime_error("Cannot open log file: " + path);
+		}
+		return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	}
+} // namespace
+
+namespace argument_parser::ingest {
+	schema::schema(std::function<void(v2::base_parser &)> options) : options(std::move(options)) {}
+
+	std::vector<schema::column_definition> const &schema::output_columns() const {
+		return columns;
+	}
+
+	void schema::register_options(v2::base_parser &parser) const {
+		options(parser);
+	}
+
+	summary ingest(std::string_view data, std::ostream &output, schema const &options,
+				   std::initializer_list<conventions::convention const *const> convention_types,
+				   settings const &config) {
+		char const delimiter = config.records == record_format::nul_delimited ? '\0' : '\n';
+		auto const chunks = split_chunks(data, delimiter, std::max<std::size_t>(config.chunk_bytes, 1));
+
+		unsigned threads = config.max_threads != 0 ? config.max_threads : std::thread::hardware_concurrency();
+		threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(chunks.size())));
+
+		// workers run at most `window` chunks ahead of the writer so memory stays bounded on huge logs
+		std::size_t const window = std::size_t{threads} * 2;
+		std::vector<std::optional<row_group>> results(chunks.size());
+		std::mutex mutex;
+		std::condition_variable changed;
+		std::size_t next_chunk = 0;
+		std::size_t written = 0;
+
+		bool stopping = false;
+		std::exception_ptr failure; // the first one a worker threw, rethrown after the pool is joined
+
+		auto worker = [&] {
+			try {
+				for (;;) {
+					std::size_t index;
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						changed.wait(lock, [&] {
+							return stopping || next_chunk >= chunks.size() || next_chunk < written + window;
+						});
+						if (stopping || next_chunk >= chunks.size()) {
+							return;
+						}
+						index = next_chunk++;
+					}
+					auto group = parse_chunk(chunks[index], delimiter, options, convention_types);
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						results[index] = std::move(group);
+					}
+					changed.notify_all();
+				}
+			} catch (...) {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if (!failure) {
+						failure = std::current_exception();
+					}
+					stopping = true;
+				}
+				changed.notify_all();
+			}
+		};
+
+		summary totals;
+		{
+			std::vector<std::thread> pool;
+			pool.reserve(threads);
+			pool_joiner joiner(pool, [&] {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					stopping = true;
+				}
+				changed.notify_all();
+			});
+			for (unsigned i = 0; i < threads; ++i) {
+				pool.emplace_back(worker);
+			}
+
+			table_writer writer(output, options, config.output);
+			writer.write_header();
+			for (std::size_t index = 0; index < chunks.size(); ++index) {
+				row_group group;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					changed.wait(lock, [&] { return stopping || results[index].has_value(); });
+					if (!results[index].has_value()) {
+						break; // a worker failed
+					}
+					group = std::move(results[index].value());
+					results[index].reset();
+					written = index + 1;
+				}
+				changed.notify_all();
+				writer.write(group);
+				totals.records += group.rows;
+				totals.errors += group.errors;
+			}
+		}
+		if (failure) {
+			std::rethrow_exception(failure);
+		}
+		output.flush();
+		return totals;
+	}
+
+	summary ingest_file(std::string const &path, std::ostream &output, schema const &options,
+						std::initializer_list<conventions::convention const *const> convention_types,
+						settings const &config) {
+#ifndef _WIN32
+		int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			throw std::runtime_error("Cannot open log file: " + path);
+		}
+		struct stat info {};
+		if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+			::close(fd);
+			return ingest(std::string_view{}, output, options, convention_types, config);
+		}
+		auto size = static_cast<std::size_t>(info.st_size);
+		void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (mapped == MAP_FAILED) {
+			auto contents = read_whole_file(path);
+			return ingest(contents, output, options, convention_types, config);
+		}
+		::madvise(mapped, size, MADV_SEQUENTIAL);
+		try {
+			auto totals = ingest(std::string_view(static_cast<char const *>(mapped), size), output, options,
+								 convention_types, config);
+			::munmap(mapped, size);
+			return totals;
+		} catch (...) {
+			::munmap(mapped, size);
+			throw;
+		}
+#else
+		auto contents = read_whole_file(path);
+		return ingest(contents, output, options, convention_types, config);
+#endif
+	}
+} // namespace argument_parser::ingest
@@ -0,0 +1,105 @@
+#include "name_index.hpp"
+
+#include <algorithm>
+
+namespace {
+	constexpr unsigned char fold(char c) noexcept {
+		auto u = static_cast<unsigned char>(c);
+		return (u >= 'A' && u <= 'Z') ? static_cast<unsigned char>(u - 'A' + 'a') : u;
+	}
+} // namespace
+
+namespace argument_parser::internal {
+	int fold_compare(std::string_view lhs, std::string_view rhs) noexcept {
+		auto common = std::min(lhs.size(), rhs.size());
+		for (std::size_t i = 0; i < common; ++i) {
+			auto l = fold(lhs[i]);
+			auto r = fold(rhs[i]);
+			if (l != r) {
+				return l < r ? -1 : 1;
+			}
+		}
+		return lhs.size() == rhs.size() ? 0 : (lhs.size() < rhs.size() ? -1 : 1);
+	}
+
+	bool fold_equal(std::string_view lhs, std::string_view rhs) noexcept {
+		return lhs.size() == rhs.size() && fold_compare(lhs, rhs) == 0;
+	}
+
+	void name_index::rebuild(std::unordered_map<std::string_view, int> const &names) {
+		entries.clear();
+		entries.reserve(names.size());
+		for (auto const &[name, id] : names) {
+			entries.push_back({name, id});
+		}
+		std::sort(entries.begin(), entries.end(), [](entry const &lhs, entry const &rhs) {
+			auto order = fold_compare(lhs.name, rhs.name);
+			return order != 0 ? order < 0 : lhs.name < rhs.name;
+		});
+	}
+
+	bool name_index::matches_query(entry const &candidate, std::string_view query, bool ignore_case,
+								   bool allow_prefix) noexcept {
+		std::string_view name = candidate.name;
+		if (allow_prefix && name.size() > query.size()) {
+			name = name.substr(0, query.size());
+		}
+		return ignore_case ? fold_equal(name, query) : name == query;
+	}
+
+	name_index::match name_index::resolve(entry const *first, entry const *last, std::string_view query,
+										  bool ignore_case, bool allow_prefix) const noexcept {
+		match result;
+		for (auto const *it = first; it != last; ++it) {
+			if (!matches_query(*it, query, ignore_case, allow_prefix)) {
+				continue;
+			}
+			if (result.status == match_status::none) {
+				result = {match_status::unique, it->id, first, last};
+			} else if (result.id != it->id) {
+				result.status = match_status::ambiguous;
+			}
+		}
+		return result;
+	}
+
+	name_index::match name_index::find(std::string_view query, bool ignore_case, bool allow_prefix) const {
+		auto const *begin = entries.data();
+		auto const *end = begin + entries.size();
+
+		// every spelling that folds to the query, then every name whose folded prefix is the query
+		auto const *equal_first = std::lower_bound(
+			begin, end, query, [](entry const &e, std::string_view q) { return fold_compare(e.name, q) < 0; });
+		auto const *equal_last = std::upper_bound(
+			equal_first, end, query, [](std::string_view q, entry const &e) { return fold_compare(q, e.name) < 0; });
+
+		// an exact spelling always wins, even over other case variants or longer names
+		for (auto const *it = equal_first; it != equal_last; ++it) {
+			if (it->name == query) {
+				return {match_status::unique, it->id, it, it + 1};
+			}
+		}
+		if (ignore_case) {
+			auto folded = resolve(equal_first, equal_last, query, true, false);
+			if (folded.status != match_status::none) {
+				return folded;
+			}
+		}
+		if (!allow_prefix || query.empty()) {
+			return {};
+		}
+
+		auto const *prefix_last = std::partition_point(equal_first, end, [query](entry const &e) {
+			return fold_compare(e.name.substr(0, query.size()), query) <= 0;
+		});
+		return resolve(equal_first, prefix_last, query, ignore_case, true);
+	}
+
+	std::size_t name_index::size() const noexcept {
+		return entries.size();
+	}
+
+	std::size_t name_index::bytes() const noexcept {
+		return sizeof(entries) + entries.capacity() * sizeof(entry);
+	}
+} // namespace argument_parser::internal
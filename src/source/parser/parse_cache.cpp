@@ -0,0 +1,90 @@
+#include "parse_cache.hpp"
+
+namespace argument_parser::internal {
+	parse_cache::parse_cache(std::size_t capacity) : capacity(capacity) {
+		index.reserve(capacity);
+	}
+
+	parse_cache::parse_cache(parse_cache const &other)
+		: capacity(other.capacity), recent(other.recent), counters(other.counters) {
+		rebuild_index();
+	}
+
+	parse_cache &parse_cache::operator=(parse_cache const &other) {
+		if (this != &other) {
+			capacity = other.capacity;
+			recent = other.recent;
+			counters = other.counters;
+			rebuild_index();
+		}
+		return *this;
+	}
+
+	void parse_cache::rebuild_index() {
+		index.clear();
+		for (auto it = recent.begin(); it != recent.end(); ++it) {
+			index.emplace(it->first, it);
+		}
+	}
+
+	std::uint64_t parse_cache::key_of(std::vector<std::string> const &tokens, std::uint64_t salt) noexcept {
+		std::uint64_t hash = 14695981039346656037ull ^ salt; // FNV-1a
+		for (auto const &token : tokens) {
+			for (unsigned char c : token) {
+				hash = (hash ^ c) * 1099511628211ull;
+			}
+			hash = (hash ^ 0xffu) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::shared_ptr<parse_cache::result const> parse_cache::find(std::uint64_t key,
+																  std::vector<std::string> const &tokens) {
+		auto found = index.find(key);
+		if (found == index.end() || found->second->second->tokens != tokens) {
+			++counters.misses;
+			return nullptr;
+		}
+		recent.splice(recent.begin(), recent, found->second);
+		++counters.hits;
+		return found->second->second;
+	}
+
+	void parse_cache::insert(std::uint64_t key, std::shared_ptr<result const> value) {
+		if (capacity == 0) {
+			return;
+		}
+		if (auto found = index.find(key); found != index.end()) {
+			found->second->second = std::move(value);
+			recent.splice(recent.begin(), recent, found->second);
+			return;
+		}
+		if (recent.size() == capacity) {
+			index.erase(recent.back().first);
+			recent.pop_back();
+			++counters.evictions;
+		}
+		recent.emplace_front(key, std::move(value));
+		index.emplace(key, recent.begin());
+	}
+
+	parse_cache_statistics parse_cache::statistics() const noexcept {
+		auto stats = counters;
+		stats.entries = recent.size();
+		return stats;
+	}
+
+	std::size_t parse_cache::bytes() const noexcept {
+		std::size_t total = sizeof(*this) + index.bucket_count() * sizeof(void *);
+		for (auto const &[key, value] : recent) {
+			total += 3 * sizeof(void *) + sizeof(entry) + sizeof(result); // list node, index node, result
+			for (auto const &token : value->tokens) {
+				total += sizeof(std::string) + token.capacity();
+			}
+			total += value->values.capacity() * sizeof(decltype(result::values)::value_type) +
+					 value->invoked.capacity() * sizeof(decltype(result::invoked)::value_type) +
+					 value->actions.capacity() * sizeof(replayed_action);
+		}
+		return total;
+	}
+} // namespace argument_parser::internal
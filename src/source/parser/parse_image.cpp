@@ -0,0 +1,178 @@
+#include "parse_image.hpp"
+
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
+namespace {
+	constexpr char magic[8] = {'A', 'P', 'I', 'M', 'G', '0', '0', '1'};
+	constexpr std::size_t header_size = 8 + 8 + 4 + 4 + 8;
+	constexpr std::size_t entry_size = 5 * 4;
+	constexpr std::uint32_t flag_invoked = 1;
+	constexpr std::uint32_t flag_has_value = 2;
+
+	template <typename T> void put(std::string &out, std::size_t offset, T value) {
+		std::memcpy(&out[offset], &value, sizeof(T));
+	}
+
+	template <typename T> T get(std::string_view bytes, std::size_t offset) {
+		T value;
+		std::memcpy(&value, bytes.data() + offset, sizeof(T));
+		return value;
+	}
+
+	std::runtime_error corrupt(std::string const &what) {
+		return std::runtime_error("Corrupt parse image: " + what);
+	}
+} // namespace
+
+namespace argument_parser::image {
+	namespace detail {
+		void append_u32(std::string &out, std::uint32_t value) {
+			out.append(reinterpret_cast<char const *>(&value), sizeof(value));
+		}
+
+		std::uint32_t read_u32(std::string_view bytes, std::size_t offset) {
+			if (offset + 4 > bytes.size()) {
+				throw corrupt("value out of bounds");
+			}
+			return get<std::uint32_t>(bytes, offset);
+		}
+	} // namespace detail
+
+	std::string write(std::uint64_t schema_hash, std::vector<entry> const &entries) {
+		std::size_t size = header_size + entries.size() * entry_size;
+		for (auto const &e : entries) {
+			size += e.key.size() + e.value.size();
+		}
+
+		std::string out(header_size + entries.size() * entry_size, '\0');
+		out.reserve(size);
+		std::memcpy(&out[0], magic, sizeof(magic));
+		put<std::uint64_t>(out, 8, schema_hash);
+		put<std::uint32_t>(out, 16, static_cast<std::uint32_t>(entries.size()));
+		put<std::uint64_t>(out, 24, size);
+
+		for (std::size_t i = 0; i < entries.size(); ++i) {
+			auto const &e = entries[i];
+			std::size_t const slot = header_size + i * entry_size;
+			put<std::uint32_t>(out, slot, static_cast<std::uint32_t>(out.size()));
+			put<std::uint32_t>(out, slot + 4, static_cast<std::uint32_t>(e.key.size()));
+			out.append(e.key);
+			put<std::uint32_t>(out, slot + 8, static_cast<std::uint32_t>(out.size()));
+			put<std::uint32_t>(out, slot + 12, static_cast<std::uint32_t>(e.value.size()));
+			out.append(e.value);
+			put<std::uint32_t>(out, slot + 16, (e.invoked ? flag_invoked : 0) | (e.has_value ? flag_has_value : 0));
+		}
+		return out;
+	}
+
+	std::vector<entry_view> read(std::string_view image, std::uint64_t expected_schema_hash) {
+		if (image.size() < header_size || std::memcmp(image.data(), magic, sizeof(magic)) != 0) {
+			throw std::runtime_error("Not a parse image");
+		}
+		if (get<std::uint64_t>(image, 8) != expected_schema_hash) {
+			throw std::runtime_error("Parse image was written for different option registrations");
+		}
+		auto const size = get<std::uint64_t>(image, 24);
+		auto const count = get<std::uint32_t>(image, 16);
+		if (size > image.size() || header_size + std::uint64_t{count} * entry_size > size) {
+			throw corrupt("truncated");
+		}
+		image = image.substr(0, static_cast<std::size_t>(size));
+
+		auto slice = [&image](std::uint32_t offset, std::uint32_t length) {
+			if (offset > image.size() || length > image.size() - offset) {
+				throw corrupt("entry out of bounds");
+			}
+			return image.substr(offset, length);
+		};
+
+		std::vector<entry_view> entries;
+		entries.reserve(count);
+		for (std::uint32_t i = 0; i < count; ++i) {
+			std::size_t const slot = header_size + std::size_t{i} * entry_size;
+			auto const flags = get<std::uint32_t>(image, slot + 16);
+			entries.push_back({slice(get<std::uint32_t>(image, slot), get<std::uint32_t>(image, slot + 4)),
+							   (flags & flag_invoked) != 0, (flags & flag_has_value) != 0,
+							   slice(get<std::uint32_t>(image, slot + 8), get<std::uint32_t>(image, slot + 12))});
+		}
+		return entries;
+	}
+
+#ifndef _WIN32
+	mapped_image::mapped_image(int fd) {
+		struct stat info {};
+		if (::fstat(fd, &info) != 0) {
+			throw std::runtime_error("Cannot stat parse image descriptor");
+		}
+		size = static_cast<std::size_t>(info.st_size);
+		if (size == 0) {
+			return;
+		}
+		void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (mapped == MAP_FAILED) {
+			throw std::runtime_error("Cannot map parse image descriptor");
+		}
+		data = mapped;
+	}
+
+	mapped_image::~mapped_image() {
+		if (data != nullptr) {
+			::munmap(const_cast<void *>(data), size);
+		}
+	}
+#else
+	mapped_image::mapped_image(int) {
+		throw std::runtime_error("Mapping parse images is not supported on this platform");
+	}
+
+	mapped_image::~mapped_image() = default;
+#endif
+
+	mapped_image::mapped_image(mapped_image &&other) noexcept
+		: data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+
+	mapped_image &mapped_image::operator=(mapped_image &&other) noexcept {
+		if (this != &other) {
+			mapped_image discarded(std::move(*this));
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0);
+		}
+		return *this;
+	}
+
+	std::string_view mapped_image::bytes() const {
+		return {static_cast<char const *>(data), size};
+	}
+
+	int to_memfd(std::string_view image, char const *name) {
+#ifdef __linux__
+		int fd = ::memfd_create(name, MFD_ALLOW_SEALING);
+		if (fd < 0) {
+			throw std::runtime_error("memfd_create failed for parse image");
+		}
+		for (std::size_t written = 0; written < image.size();) {
+			auto count = ::write(fd, image.data() + written, image.size() - written);
+			if (count <= 0) {
+				::close(fd);
+				throw std::runtime_error("Cannot write parse image to memfd");
+			}
+			written += static_cast<std::size_t>(count);
+		}
+		::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+		return fd;
+#else
+		(void)image;
+		(void)name;
+		throw std::runtime_error("memfd is only available on Linux");
+#endif
+	}
+} // namespace argument_parser::image
@@ -5,26 +5,53 @@
 #include <fstream>
 #include <string>
 
-namespace argument_parser {
-	linux_parser::linux_parser() {
+namespace {
+	int captured_argc = 0;
+	char **captured_argv = nullptr;
+
+	// glibc calls .init_array entries with the same argc/argv/envp it hands to main
+	void capture_arguments(int argc, char **argv, char ** /*envp*/) {
+		captured_argc = argc;
+		captured_argv = argv;
+	}
+
+	[[gnu::used, gnu::section(".init_array")]] void (*const capture_arguments_hook)(int, char **,
+																				  char **) = &capture_arguments;
+
+	/**
+	 * @brief Calls on_program with argv[0] and on_argument with every later argument. Reads the captured argv when
+	 * the loader passed it (glibc), otherwise /proc/self/cmdline (musl, or a parser built before the hook ran).
+	 */
+	template <typename OnProgram, typename OnArgument>
+	void read_command_line(OnProgram &&on_program, OnArgument &&on_argument) {
+		if (captured_argc > 0 && captured_argv != nullptr && captured_argv[0] != nullptr) {
+			on_program(captured_argv[0]);
+			for (int i = 1; i < captured_argc && captured_argv[i] != nullptr; ++i) {
+				on_argument(captured_argv[i]);
+			}
+			return;
+		}
+
 		std::ifstream command_line_file{"/proc/self/cmdline"};
-		std::getline(command_line_file, program_name, '\0');
-		for (std::string line; std::getline(command_line_file, line, '\0');) {
-			parsed_arguments.emplace_back(line);
+		std::string line;
+		std::getline(command_line_file, line, '\0');
+		on_program(line);
+		while (std::getline(command_line_file, line, '\0')) {
+			on_argument(line);
 		}
 	}
+} // namespace
+
+namespace argument_parser {
+	linux_parser::linux_parser() {
+		read_command_line([this](auto const &name) { program_name = name; },
+						  [this](auto const &arg) { parsed_arguments.emplace_back(arg); });
+	}
 
 	namespace v2 {
 		linux_parser::linux_parser(bool should_exit) {
-			std::ifstream command_line_file{"/proc/self/cmdline"};
-			std::string program_name;
-			std::getline(command_line_file, program_name, '\0');
-			set_program_name(program_name);
-
-			for (std::string line; std::getline(command_line_file, line, '\0');) {
-				ref_parsed_args().emplace_back(line);
-			}
-
+			read_command_line([this](auto const &name) { set_program_name(name); },
+							  [this](auto const &arg) { ref_parsed_args().emplace_back(arg); });
 			prepare_help_flag(should_exit);
 		}
 	} // namespace v2
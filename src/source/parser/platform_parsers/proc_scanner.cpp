@@ -0,0 +1,163 @@
+#ifdef __linux__
+
+#include "proc_scanner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <dirent.h>
+#include <exception>
+#include <fcntl.h>
+#include <optional>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+	std::vector<pid_t> list_pids() {
+		std::vector<pid_t> pids;
+		DIR *proc = opendir("/proc");
+		if (proc == nullptr) {
+			return pids;
+		}
+		while (dirent *entry = readdir(proc)) {
+			pid_t pid = 0;
+			char const *c = entry->d_name;
+			for (; *c >= '0' && *c <= '9'; ++c) {
+				pid = pid * 10 + (*c - '0');
+			}
+			if (*c == '\0' && c != entry->d_name) {
+				pids.push_back(pid);
+			}
+		}
+		closedir(proc);
+		std::sort(pids.begin(), pids.end());
+		return pids;
+	}
+
+	void parse_tokens(argument_parser::proc::cmdline_reader const &reader,
+					  argument_parser::proc::schema const &options,
+					  std::initializer_list<argument_parser::conventions::convention const *const> convention_types,
+					  argument_parser::proc::scan_result &result) {
+		auto const &tokens = reader.tokens();
+		result.program.assign(reader.program());
+		try {
+			auto parser = std::make_unique<argument_parser::v2::fake_parser>(
+				result.program, std::vector<std::string>(tokens.begin() + 1, tokens.end()));
+			parser->set_dry_run(true);
+			options(*parser);
+			parser->handle_arguments(convention_types);
+			result.parsed = std::move(parser);
+		} catch (std::exception const &e) {
+			result.error = e.what();
+		}
+	}
+} // namespace
+
+namespace argument_parser::proc {
+	bool cmdline_reader::read(pid_t pid) {
+		views.clear();
+		char path[32];
+		std::snprintf(path, sizeof(path), "/proc/%d/cmdline", static_cast<int>(pid));
+		int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			return false;
+		}
+
+		std::size_t length = 0;
+		for (;;) {
+			ssize_t count = ::pread(fd, buffer.data() + length, buffer.size() - length, static_cast<off_t>(length));
+			if (count < 0 && errno == EINTR) {
+				continue;
+			}
+			if (count <= 0) {
+				break;
+			}
+			length += static_cast<std::size_t>(count);
+			if (length < buffer.size()) {
+				break; // a short read is the end of the file
+			}
+			buffer.resize(buffer.size() * 2);
+		}
+		::close(fd);
+
+		for (std::size_t start = 0; start < length;) {
+			char const *begin = buffer.data() + start;
+			char const *end = std::find(begin, begin + (length - start), '\0');
+			views.emplace_back(begin, static_cast<std::size_t>(end - begin));
+			start += views.back().size() + 1;
+		}
+		return !views.empty();
+	}
+
+	std::string_view cmdline_reader::program() const {
+		return views.empty() ? std::string_view{} : views.front();
+	}
+
+	std::vector<std::string_view> const &cmdline_reader::tokens() const {
+		return views;
+	}
+
+	std::function<bool(std::string_view)> program_named(std::string name) {
+		return [name = std::move(name)](std::string_view program) {
+			auto slash = program.rfind('/');
+			return (slash == std::string_view::npos ? program : program.substr(slash + 1)) == name;
+		};
+	}
+
+	bool parse_process(pid_t pid, schema const &options,
+					   std::initializer_list<conventions::convention const *const> convention_types,
+					   cmdline_reader &reader, scan_result &result) {
+		if (!reader.read(pid)) {
+			return false;
+		}
+		result.pid = pid;
+		parse_tokens(reader, options, convention_types, result);
+		return true;
+	}
+
+	std::vector<scan_result> scan(schema const &options,
+								  std::initializer_list<conventions::convention const *const> convention_types,
+								  scan_options const &settings) {
+		auto const pids = list_pids();
+		std::vector<std::optional<scan_result>> slots(pids.size());
+
+		constexpr std::size_t batch = 64;
+		std::atomic_size_t next{0};
+		auto worker = [&] {
+			cmdline_reader reader;
+			for (std::size_t first; (first = next.fetch_add(batch)) < pids.size();) {
+				for (std::size_t i = first; i < std::min(first + batch, pids.size()); ++i) {
+					if (!reader.read(pids[i]) || (settings.filter && !settings.filter(reader.program()))) {
+						continue;
+					}
+					auto &result = slots[i].emplace();
+					result.pid = pids[i];
+					parse_tokens(reader, options, convention_types, result);
+				}
+			}
+		};
+
+		unsigned threads = settings.max_threads != 0 ? settings.max_threads : std::thread::hardware_concurrency();
+		threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(pids.size() / batch + 1)));
+		std::vector<std::thread> pool;
+		pool.reserve(threads - 1);
+		for (unsigned i = 1; i < threads; ++i) {
+			pool.emplace_back(worker);
+		}
+		worker();
+		for (auto &thread : pool) {
+			thread.join();
+		}
+
+		std::vector<scan_result> results;
+		for (auto &slot : slots) {
+			if (slot.has_value()) {
+				results.push_back(std::move(slot.value()));
+			}
+		}
+		return results;
+	}
+} // namespace argument_parser::proc
+
+#endif
@@ -0,0 +1,255 @@
+#include "plugin_registry.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace {
+	class shared_library {
+	public:
+		explicit shared_library(std::string const &path) {
+#ifdef _WIN32
+			handle = ::LoadLibraryA(path.c_str());
+			if (handle == nullptr) {
+				throw std::runtime_error("Could not load plugin '" + path + "' (error " +
+										 std::to_string(::GetLastError()) + ")");
+			}
+#else
+			handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+			if (handle == nullptr) {
+				const char *reason = ::dlerror();
+				throw std::runtime_error("Could not load plugin '" + path +
+										 "': " + (reason ? reason : "unknown error"));
+			}
+#endif
+		}
+
+		~shared_library() {
+#ifdef _WIN32
+			::FreeLibrary(handle);
+#else
+			::dlclose(handle);
+#endif
+		}
+
+		shared_library(shared_library const &) = delete;
+		shared_library &operator=(shared_library const &) = delete;
+
+		void *symbol(const char *name) const {
+#ifdef _WIN32
+			return reinterpret_cast<void *>(::GetProcAddress(handle, name));
+#else
+			return ::dlsym(handle, name);
+#endif
+		}
+
+	private:
+#ifdef _WIN32
+		HMODULE handle;
+#else
+		void *handle;
+#endif
+	};
+
+	// opened by the first selection of its subcommand, then kept by the subcommand's factory for the parser's
+	// lifetime so a reparse does not load and relocate the library again
+	class lazy_library {
+	public:
+		explicit lazy_library(std::string path) : path(std::move(path)) {}
+
+		std::shared_ptr<shared_library> const &get() {
+			if (!loaded) {
+				loaded = std::make_shared<shared_library>(path);
+			}
+			return loaded;
+		}
+
+	private:
+		std::string path;
+		std::shared_ptr<shared_library> loaded;
+	};
+
+	struct host_context {
+		argument_parser::v2::base_parser *parser;
+		std::shared_ptr<shared_library> library;
+		std::string error;
+	};
+
+	using argument_parser::v2::add_argument_flags;
+	using non_typed_map =
+		std::unordered_map<add_argument_flags, argument_parser::v2::base_parser::non_typed_flag_value>;
+	using string_map =
+		std::unordered_map<add_argument_flags, argument_parser::v2::base_parser::typed_flag_value<std::string>>;
+
+	template <typename Map>
+	void add_common_pairs(Map &pairs, const char *short_name, const char *long_name, const char *help_text,
+						  int required) {
+		if (short_name != nullptr) {
+			pairs[add_argument_flags::ShortArgument] = std::string(short_name);
+		}
+		if (long_name != nullptr) {
+			pairs[add_argument_flags::LongArgument] = std::string(long_name);
+		}
+		if (help_text != nullptr) {
+			pairs[add_argument_flags::HelpText] = std::string(help_text);
+		}
+		pairs[add_argument_flags::Required] = required != 0;
+	}
+
+	template <typename Function> int guarded(void *context, Function const &function) {
+		auto *host = static_cast<host_context *>(context);
+		try {
+			function(*host);
+			return 0;
+		} catch (std::exception const &e) {
+			host->error = e.what();
+			return 1;
+		}
+	}
+
+	int add_flag(void *context, const char *short_name, const char *long_name, const char *help_text, int required) {
+		return guarded(context, [&](host_context &host) {
+			non_typed_map pairs;
+			add_common_pairs(pairs, short_name, long_name, help_text, required);
+			host.parser->add_argument(pairs);
+		});
+	}
+
+	int add_action(void *context, const char *short_name, const char *long_name, const char *help_text, int required,
+				   argparse_plugin_action_fn callback, void *user_data) {
+		return guarded(context, [&](host_context &host) {
+			if (callback == nullptr) {
+				throw std::invalid_argument("add_action requires a callback");
+			}
+			non_typed_map pairs;
+			add_common_pairs(pairs, short_name, long_name, help_text, required);
+			pairs[add_argument_flags::Action] = argument_parser::helpers::make_non_parametered_action(
+				[library = host.library, callback, user_data] { callback(user_data); });
+			host.parser->add_argument(pairs);
+		});
+	}
+
+	int add_option(void *context, const char *short_name, const char *long_name, const char *help_text, int required,
+				   argparse_plugin_value_fn callback, void *user_data) {
+		return guarded(context, [&](host_context &host) {
+			string_map pairs;
+			add_common_pairs(pairs, short_name, long_name, help_text, required);
+			if (callback != nullptr) {
+				pairs[add_argument_flags::Action] = argument_parser::helpers::make_parametered_action<std::string>(
+					[library = host.library, callback, user_data](std::string const &value) {
+						callback(user_data, value.c_str());
+					});
+			}
+			host.parser->add_argument<std::string>(pairs);
+		});
+	}
+
+	int add_positional(void *context, const char *name, const char *help_text, int required, int position,
+					   argparse_plugin_value_fn callback, void *user_data) {
+		return guarded(context, [&](host_context &host) {
+			if (name == nullptr) {
+				throw std::invalid_argument("add_positional requires a name");
+			}
+			string_map pairs;
+			add_common_pairs(pairs, nullptr, nullptr, help_text, required);
+			pairs[add_argument_flags::Positional] = std::string(name);
+			if (position >= 0) {
+				pairs[add_argument_flags::Position] = position;
+			}
+			if (callback != nullptr) {
+				pairs[add_argument_flags::Action] = argument_parser::helpers::make_parametered_action<std::string>(
+					[library = host.library, callback, user_data](std::string const &value) {
+						callback(user_data, value.c_str());
+					});
+			}
+			host.parser->add_argument<std::string>(pairs);
+		});
+	}
+
+	const char *last_error(void *context) {
+		return static_cast<host_context *>(context)->error.c_str();
+	}
+
+	void register_plugin(argument_parser::v2::base_parser &parser, std::string const &subcommand,
+						 std::string const &library_path, std::shared_ptr<shared_library> library) {
+		host_context context{&parser, std::move(library), {}};
+
+		auto entry_point =
+			reinterpret_cast<argparse_plugin_register_fn>(context.library->symbol(ARGPARSE_PLUGIN_ENTRY_POINT));
+		if (entry_point == nullptr) {
+			throw std::runtime_error("Plugin '" + library_path + "' does not export " ARGPARSE_PLUGIN_ENTRY_POINT);
+		}
+
+		argparse_plugin_host host{ARGPARSE_PLUGIN_ABI_VERSION,
+								  &context,
+								  subcommand.c_str(),
+								  &add_flag,
+								  &add_action,
+								  &add_option,
+								  &add_positional,
+								  &last_error};
+
+		// a failing entry point may have registered some options already; they go again, and with their actions
+		// the references to the library they took
+		parser.register_atomically([&] {
+			if (entry_point(&host) != 0) {
+				throw std::runtime_error("Plugin '" + library_path + "' failed to register subcommand '" +
+										 subcommand + "'" + (context.error.empty() ? "" : ": " + context.error));
+			}
+		});
+	}
+
+	auto find_entry(std::vector<argument_parser::plugins::plugin_entry> const &plugins, std::string const &name) {
+		return std::lower_bound(plugins.begin(), plugins.end(), name,
+								[](argument_parser::plugins::plugin_entry const &entry, std::string const &key) {
+									return entry.name < key;
+								});
+	}
+} // namespace
+
+namespace argument_parser::plugins {
+	void plugin_registry::add(std::string const &name, std::string const &library_path, std::string const &help_text) {
+		auto it = find_entry(plugins, name);
+		if (it != plugins.end() && it->name == name) {
+			throw std::runtime_error("Plugin for subcommand '" + name + "' already exists!");
+		}
+		plugins.insert(it, {name, library_path, help_text});
+	}
+
+	std::optional<plugin_entry> plugin_registry::find(std::string const &name) const {
+		auto it = find_entry(plugins, name);
+		if (it != plugins.end() && it->name == name) {
+			return *it;
+		}
+		return std::nullopt;
+	}
+
+	std::vector<plugin_entry> const &plugin_registry::entries() const {
+		return plugins;
+	}
+
+	void plugin_registry::install(v2::base_parser &parser) const {
+		for (auto const &plugin : plugins) {
+			add_plugin_subcommand(parser, plugin.name, plugin.library_path, plugin.help_text);
+		}
+	}
+
+	void add_plugin_subcommand(v2::base_parser &parser, std::string const &name, std::string const &library_path,
+							   std::string const &help_text) {
+		auto library = std::make_shared<lazy_library>(library_path);
+		parser.add_subcommand(name, help_text, [name, library_path, library](v2::base_parser &selected) {
+			register_plugin(selected, name, library_path, library->get());
+		});
+	}
+
+	void load_plugin(v2::base_parser &parser, std::string const &subcommand, std::string const &library_path) {
+		register_plugin(parser, subcommand, library_path, std::make_shared<shared_library>(library_path));
+	}
+} // namespace argument_parser::plugins
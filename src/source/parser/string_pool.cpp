@@ -0,0 +1,61 @@
+#include "string_pool.hpp"
+
+#include <cstring>
+
+namespace argument_parser::internal {
+	std::string_view string_pool::intern(std::string_view text) {
+		if (auto existing = strings.find(text); existing != strings.end()) {
+			return *existing;
+		}
+		if (text.empty()) {
+			return *strings.insert(std::string_view{}).first;
+		}
+
+		char *storage = allocate(text.size());
+		std::memcpy(storage, text.data(), text.size());
+		return *strings.insert(std::string_view(storage, text.size())).first;
+	}
+
+	std::string_view string_pool::copy(std::initializer_list<std::string_view> parts) {
+		std::size_t length = 0;
+		for (auto part : parts) {
+			length += part.size();
+		}
+		char *storage = allocate(length);
+		char *out = storage;
+		for (auto part : parts) {
+			std::memcpy(out, part.data(), part.size());
+			out += part.size();
+		}
+		copied++;
+		return {storage, length};
+	}
+
+	char *string_pool::allocate(std::size_t length) {
+		if (length > block_size / 4) {
+			// long help texts get a block of their own instead of wasting the tail of the current one
+			blocks.emplace_back(new char[length]);
+			reserved_bytes += length;
+			return blocks.back().get();
+		}
+		if (current == nullptr || block_size - block_used < length) {
+			blocks.emplace_back(new char[block_size]);
+			reserved_bytes += block_size;
+			current = blocks.back().get();
+			block_used = 0;
+		}
+		char *storage = current + block_used;
+		block_used += length;
+		return storage;
+	}
+
+	std::size_t string_pool::size() const noexcept {
+		return strings.size() + copied;
+	}
+
+	std::size_t string_pool::bytes() const noexcept {
+		return sizeof(*this) + reserved_bytes + blocks.capacity() * sizeof(blocks.front()) +
+			   strings.bucket_count() * sizeof(void *) +
+			   strings.size() * (2 * sizeof(void *) + sizeof(std::string_view));
+	}
+} // namespace argument_parser::internal
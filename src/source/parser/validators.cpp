@@ -0,0 +1,45 @@
+#include "validators.hpp"
+
+#include <mutex>
+#include <regex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+	class regex_constraint
+		: public argument_parser::validators::detail::basic_constraint<std::string, regex_constraint> {
+	public:
+		regex_constraint(std::string const &pattern, std::shared_ptr<std::regex const> compiled)
+			: basic_constraint("expected a value matching " + pattern), compiled(std::move(compiled)) {}
+
+		bool check(std::string const &value) const {
+			return std::regex_match(value, *compiled);
+		}
+
+	private:
+		std::shared_ptr<std::regex const> compiled;
+	};
+
+	std::shared_ptr<std::regex const> compile_shared(std::string const &pattern) {
+		static std::mutex cache_mutex;
+		static std::unordered_map<std::string, std::shared_ptr<std::regex const>> cache;
+
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		auto &slot = cache[pattern];
+		if (slot == nullptr) {
+			try {
+				slot = std::make_shared<std::regex const>(pattern, std::regex::ECMAScript | std::regex::optimize);
+			} catch (std::regex_error const &e) {
+				cache.erase(pattern);
+				throw std::logic_error("Invalid validator pattern '" + pattern + "': " + e.what());
+			}
+		}
+		return slot;
+	}
+} // namespace
+
+namespace argument_parser::validators {
+	constraint_ptr<std::string> matches(std::string const &pattern) {
+		return std::make_shared<regex_constraint const>(pattern, compile_shared(pattern));
+	}
+} // namespace argument_parser::validators
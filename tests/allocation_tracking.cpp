@@ -0,0 +1,106 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+#include <instrumentation.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+using argument_parser::instrumentation::allocation_tracker;
+using argument_parser::instrumentation::parse_phase;
+
+namespace {
+	void register_schema(argument_parser::v2::fake_parser &parser) {
+		argument::start().long_argument("name").store<std::string>().build(parser);
+		argument::start().short_argument("v").flag().build(parser);
+		argument::start().positional("file").build(parser);
+	}
+
+	std::size_t entries_of(argument_parser::v2::fake_parser const &parser, const char *table) {
+		auto const tables = parser.footprint();
+		auto it = std::find_if(tables.begin(), tables.end(),
+							   [table](auto const &footprint) { return std::strcmp(footprint.table, table) == 0; });
+		return it == tables.end() ? 0 : it->entries;
+	}
+} // namespace
+
+TEST_CASE(allocations_are_attributed_to_phases) {
+	allocation_tracker tracker;
+	argument_parser::v2::fake_parser parser("tool", {"--name", "a value long enough to leave the SSO buffer", "-v",
+													 "input.txt"});
+	parser.set_allocation_tracker(&tracker);
+	register_schema(parser);
+	CHECK(tracker.at(parse_phase::registration).allocations > 0);
+
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(tracker.at(parse_phase::invoke_arguments).bytes > 0);
+	CHECK(tracker.total().allocations >= tracker.at(parse_phase::registration).allocations);
+	CHECK(tracker.report().find("total: ") != std::string::npos);
+
+	tracker.reset();
+	CHECK(tracker.total().allocations == 0);
+}
+
+TEST_CASE(untracked_allocations_are_not_counted) {
+	allocation_tracker tracker;
+	argument_parser::v2::fake_parser parser("tool", {"-v"});
+	parser.set_allocation_tracker(&tracker);
+	register_schema(parser);
+	auto const before = tracker.total().allocations;
+	std::string outside(256, 'x');
+	CHECK(tracker.total().allocations == before);
+}
+
+TEST_CASE(footprint_lists_the_schema_tables) {
+	argument_parser::v2::fake_parser parser("tool", {"-v"});
+	register_schema(parser);
+	CHECK(entries_of(parser, "argument_map") >= 3);
+	CHECK(entries_of(parser, "long_arguments") >= 1);
+	CHECK(entries_of(parser, "positional_arguments") == 1);
+}
+
+TEST_CASE(over_aligned_allocations_are_counted) {
+	struct alignas(64) wide {
+		char bytes[64];
+	};
+
+	allocation_tracker tracker;
+	argument_parser::v2::fake_parser parser("tool", {"--go"});
+	parser.set_allocation_tracker(&tracker);
+	argument::start()
+		.long_argument("go")
+		.action([] {
+			auto block = std::make_unique<wide>();
+			CHECK(reinterpret_cast<std::uintptr_t>(block.get()) % alignof(wide) == 0);
+		})
+		.build(parser);
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(tracker.at(parse_phase::invoke_arguments).bytes >= sizeof(wide));
+}
+
+TEST_CASE(a_nested_untracked_parser_is_not_billed_to_the_outer_one) {
+	constexpr std::size_t inner_block = 1 << 20;
+	argument_parser::v2::fake_parser inner("inner", {"--big"});
+	argument::start().long_argument("big").action([] { std::vector<char> block(inner_block); }).build(inner);
+
+	allocation_tracker tracker;
+	std::size_t billed_during_inner = 0;
+	argument_parser::v2::fake_parser outer("outer", {"--run"});
+	outer.set_allocation_tracker(&tracker);
+	argument::start()
+		.long_argument("run")
+		.action([&] {
+			auto const before = tracker.total().bytes;
+			inner.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+			billed_during_inner = tracker.total().bytes - before;
+		})
+		.build(outer);
+	outer.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(billed_during_inner < inner_block);
+}
@@ -0,0 +1,35 @@
+// Run with: --name "two words" --count 3 last
+#include "test_support.hpp"
+
+#include <argparse>
+
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+
+TEST_CASE(the_platform_parser_reads_the_process_arguments) {
+	argument_parser::v2::linux_parser parser(false);
+	argument::start().long_argument("name").store<std::string>().build(parser);
+	argument::start().long_argument("count").store<int>().build(parser);
+	argument::start().positional("rest").store<std::string>().build(parser);
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(parser.get_optional<std::string>("name") == std::string("two words"));
+	CHECK(parser.get_optional<int>("count") == 3);
+	CHECK(parser.get_optional<std::string>("rest") == std::string("last"));
+}
+
+TEST_CASE(every_parser_sees_the_same_arguments) {
+	argument_parser::linux_parser first;
+	argument_parser::linux_parser second;
+	first.add_argument<std::string>("n", "name", "", false);
+	second.add_argument<std::string>("n", "name", "", false);
+	first.add_argument<int>("c", "count", "", false);
+	second.add_argument<int>("c", "count", "", false);
+	first.add_positional_argument<std::string>("rest", "", false);
+	second.add_positional_argument<std::string>("rest", "", false);
+	first.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	second.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(first.get_optional<std::string>("name") == second.get_optional<std::string>("name"));
+	CHECK(second.get_optional<int>("count") == 3);
+}
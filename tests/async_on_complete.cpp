@@ -0,0 +1,61 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+using argument = argument_parser::builder::argument<>;
+using test_support::parse;
+
+TEST_CASE(handlers_run_after_their_predecessors) {
+	argument_parser::v2::fake_parser parser("tool", {"--n", "3"});
+	argument::start().long_argument("n").store<int>().build(parser);
+	std::atomic<int> finished{0};
+	std::atomic<bool> serial_first{false};
+	std::atomic<bool> ordered{false};
+	std::atomic<int> seen{0};
+	parser.on_complete([&](auto const &) { serial_first = finished == 0; });
+	parser.on_complete_async("db", [&](argument_parser::base_parser const &) { ++finished; });
+	parser.on_complete_async("cache", [&](argument_parser::base_parser const &completed) {
+		seen = completed.get_optional<int>("n").value_or(0);
+		++finished;
+	});
+	parser.on_complete_async("web", [&](argument_parser::base_parser const &) { ordered = finished == 2; },
+							 {"db", "cache"});
+	parse(parser);
+	parser.completion("web").get();
+	parser.wait();
+	CHECK(serial_first.load());
+	CHECK(ordered.load());
+	CHECK(seen == 3);
+}
+
+TEST_CASE(a_failure_reaches_wait_and_its_dependents) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	std::atomic<bool> dependent_ran{false};
+	parser.on_complete_async("bad", [](argument_parser::base_parser const &) { throw std::runtime_error("bad"); });
+	parser.on_complete_async("after", [&](argument_parser::base_parser const &) { dependent_ran = true; }, {"bad"});
+	parse(parser);
+	CHECK_THROWS_AS(parser.wait(), std::runtime_error);
+	CHECK_THROWS_AS(parser.completion("after").get(), std::runtime_error);
+	CHECK(!dependent_ran.load());
+}
+
+TEST_CASE(unknown_predecessors_are_rejected) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	CHECK_THROWS_AS(parser.on_complete_async("x", [](argument_parser::base_parser const &) {}, {"missing"}),
+					std::logic_error);
+}
+
+TEST_CASE(dry_run_skips_the_handlers) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	std::atomic<bool> ran{false};
+	parser.on_complete_async("x", [&](argument_parser::base_parser const &) { ran = true; });
+	parser.set_dry_run(true);
+	parse(parser);
+	parser.wait();
+	CHECK(!ran.load());
+}
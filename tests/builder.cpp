@@ -0,0 +1,80 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+
+namespace {
+	template <typename Builder, typename = void> struct steps_on_lvalues : std::false_type {};
+	template <typename Builder>
+	struct steps_on_lvalues<Builder, std::void_t<decltype(std::declval<Builder &>().template store<int>())>>
+		: std::true_type {};
+
+	template <typename Builder, typename = void> struct steps_on_rvalues : std::false_type {};
+	template <typename Builder>
+	struct steps_on_rvalues<Builder, std::void_t<decltype(std::declval<Builder &&>().template store<int>())>>
+		: std::true_type {};
+
+	using named_builder = decltype(argument::start().long_argument("port"));
+	static_assert(!steps_on_lvalues<named_builder>::value, "builder steps must only be callable on rvalues");
+	static_assert(steps_on_rvalues<named_builder>::value);
+
+	std::size_t table_bytes(argument_parser::v2::base_parser const &parser, std::string const &name) {
+		for (auto const &table : parser.footprint()) {
+			if (name == table.table) {
+				return table.bytes;
+			}
+		}
+		return 0;
+	}
+} // namespace
+
+TEST_CASE(build_all_registers_every_builder) {
+	int hits = 0;
+	argument_parser::v2::fake_parser parser("tool", {"--port", "80", "-v", "-v", "in.txt", "--go"});
+	argument_parser::builder::build_all(parser, argument::start().long_argument("port").store<int>(),
+										argument::start().short_argument("v").count(),
+										argument::start().positional("input").store<std::string>(),
+										argument::start().long_argument("go").action([&] { ++hits; }),
+										argument::start().long_argument("level").store<int>().default_value(3));
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(parser.get_optional<int>("port") == 80);
+	CHECK(parser.get_optional<int>("v") == 2);
+	CHECK(parser.get_optional<std::string>("input") == std::string("in.txt"));
+	CHECK(parser.get_optional<int>("level") == 3);
+	CHECK(hits == 1);
+}
+
+TEST_CASE(a_copied_partial_builder_keeps_its_state) {
+	argument_parser::v2::fake_parser first("tool", {"--port", "81"});
+	argument_parser::v2::fake_parser second("tool", {"--port", "82"});
+	auto port = argument::start().long_argument("port").help_text("Listening port.");
+	auto copy = port;
+	std::move(port).store<int>().build(first);
+	std::move(copy).store<int>().build(second);
+	first.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	second.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(first.get_optional<int>("port") == 81);
+	CHECK(second.get_optional<int>("port") == 82);
+	auto const help = second.to_v1().build_help_text({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(help.find("Listening port.") != std::string::npos);
+}
+
+TEST_CASE(reserve_makes_room_before_registration) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	auto const before = table_bytes(parser, "argument_map");
+	parser.reserve(1000, 10);
+	CHECK(table_bytes(parser, "argument_map") > before);
+	for (int i = 0; i < 1000; ++i) {
+		argument::start().long_argument("option-" + std::to_string(i)).store<int>().build(parser);
+	}
+	parser.set_parsed_arguments({"--option-999", "9"});
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(parser.get_optional<int>("option-999") == 9);
+}
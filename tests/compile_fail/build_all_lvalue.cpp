@@ -0,0 +1,10 @@
+// Must not compile: build_all() consumes its builders, so a named builder has to be moved in.
+#include <argument_builder.hpp>
+
+using argument = argument_parser::builder::argument<>;
+
+auto main() -> int {
+	argument_parser::v2::base_parser *parser = nullptr;
+	auto port = argument::start().long_argument("port").store<int>();
+	argument_parser::builder::build_all(*parser, port);
+}
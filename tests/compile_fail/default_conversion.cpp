@@ -0,0 +1,15 @@
+// Must not compile: a default whose type cannot become the stored type is rejected by a static_assert.
+#include <argument_builder.hpp>
+
+#include <string>
+
+using argument = argument_parser::builder::argument<>;
+
+auto main() -> int {
+	argument_parser::v2::base_parser *parser = nullptr;
+#ifdef APPEND_DEFAULT
+	argument::start().long_argument("include").append<int>().default_value(std::string("x")).build(*parser);
+#else
+	argument::start().long_argument("jobs").store<int>().default_value(std::string("x")).build(*parser);
+#endif
+}
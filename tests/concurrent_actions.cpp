@@ -0,0 +1,72 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+using argument = argument_parser::builder::argument<>;
+using test_support::parse;
+
+namespace {
+	struct rejected {};
+} // namespace
+
+template <> struct argument_parser::parsing_traits::parser_trait<rejected> {
+	static rejected parse(std::string const &) {
+		throw std::runtime_error("rejected");
+	}
+};
+
+TEST_CASE(dependents_start_after_their_dependencies) {
+	argument_parser::v2::fake_parser parser("tool", {"--c", "3", "--a", "1", "--b", "2", "--d", "4"});
+	parser.set_concurrent_actions(true, 4);
+	std::atomic<int> finished{0};
+	std::atomic<bool> ordered{false};
+	argument::start().long_argument("a").action<std::string>([&](std::string const &) { ++finished; }).build(parser);
+	argument::start().long_argument("b").action<std::string>([&](std::string const &) { ++finished; }).build(parser);
+	argument::start()
+		.long_argument("c")
+		.action<std::string>([&](std::string const &) { ordered = finished == 2; })
+		.depends_on({"a", "b"})
+		.build(parser);
+	argument::start().long_argument("d").store<int>().build(parser);
+	parse(parser);
+	CHECK(ordered.load());
+	CHECK(parser.get_optional<int>("d") == 4);
+}
+
+TEST_CASE(repeated_occurrences_all_run) {
+	argument_parser::v2::fake_parser parser("tool", {"-x", "-x", "-x"});
+	parser.set_concurrent_actions(true);
+	std::atomic<int> calls{0};
+	argument::start().short_argument("x").action([&calls] { ++calls; }).build(parser);
+	parse(parser);
+	CHECK(calls == 3);
+}
+
+TEST_CASE(a_failure_skips_its_dependents) {
+	argument_parser::v2::fake_parser parser("tool", {"--a", "bad", "--c", "1"});
+	parser.set_concurrent_actions(true);
+	std::atomic<bool> dependent_ran{false};
+	argument::start().long_argument("a").action<rejected>([](rejected const &) {}).build(parser);
+	argument::start()
+		.long_argument("c")
+		.action<std::string>([&](std::string const &) { dependent_ran = true; })
+		.depends_on({"a"})
+		.build(parser);
+	CHECK_THROWS_AS(parse(parser), std::runtime_error);
+	CHECK(!dependent_ran.load());
+}
+
+TEST_CASE(dependency_cycles_are_rejected) {
+	argument_parser::v2::fake_parser parser("tool", {"--a", "1", "--c", "1"});
+	parser.set_concurrent_actions(true);
+	argument::start().long_argument("a").action<std::string>([](std::string const &) {}).depends_on({"c"}).build(
+		parser);
+	argument::start().long_argument("c").action<std::string>([](std::string const &) {}).depends_on({"a"}).build(
+		parser);
+	CHECK_THROWS_AS(parse(parser), std::logic_error);
+}
@@ -0,0 +1,120 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <constraints.hpp>
+#include <fake_parser.hpp>
+
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+using argument_parser::internal::constraint_set;
+using argument_parser::internal::option_bits;
+
+namespace {
+	option_bits bits_of(std::vector<std::size_t> const &indices) {
+		option_bits bits;
+		for (auto index : indices) {
+			bits.set(index);
+		}
+		return bits;
+	}
+
+	std::vector<std::size_t> violated(constraint_set const &set, std::vector<std::size_t> const &seen) {
+		std::vector<std::size_t> result;
+		set.check(bits_of(seen), result);
+		return result;
+	}
+
+	// formats: --json/--yaml/--csv, exclusive (group 0); --input/--stdin, at least one (group 1);
+	// --tls-key requires --tls-cert and --port (group 2); --name is required
+	void register_options(argument_parser::v2::fake_parser &parser) {
+		for (char const *name : {"json", "yaml", "csv", "input", "stdin", "tls-key", "tls-cert"}) {
+			argument::start().long_argument(name).build(parser);
+		}
+		argument::start().long_argument("port").store<int>().build(parser);
+		argument::start().long_argument("name").store<std::string>().required().build(parser);
+		parser.add_mutually_exclusive_group({"json", "yaml", "csv"});
+		parser.add_at_least_one_group({"input", "stdin"});
+		parser.add_requirements("tls-key", {"tls-cert", "port"});
+	}
+
+	argument_parser::requirement_error const *parse(std::vector<std::string> const &arguments,
+												   argument_parser::requirement_error &storage) {
+		argument_parser::v2::fake_parser parser("tool", arguments);
+		register_options(parser);
+		parser.exit_on_requirement_errors(false);
+		try {
+			parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+		} catch (argument_parser::requirement_error const &e) {
+			storage = e;
+			return &storage;
+		}
+		return nullptr;
+	}
+} // namespace
+
+TEST_CASE(groups_are_checked_as_bitmasks) {
+	constraint_set set;
+	set.add_group(constraint_set::kind::mutually_exclusive, {1, 2, 130});
+	set.add_group(constraint_set::kind::at_least_one, {3, 70});
+	set.add_requirement(4, {5, 200});
+	CHECK(violated(set, {3}).empty());
+	CHECK(violated(set, {1, 130, 70}) == std::vector<std::size_t>{0});
+	CHECK(violated(set, {1, 2}) == std::vector<std::size_t>{0, 1});
+	CHECK(violated(set, {70, 4, 5}) == std::vector<std::size_t>{2});
+	CHECK(violated(set, {70, 4, 5, 200}).empty());
+	CHECK(set.members_of(0) == std::vector<std::size_t>{1, 2, 130});
+	CHECK(set.subject_of(2) == 4);
+}
+
+TEST_CASE(required_indices_are_reported_in_order) {
+	constraint_set set;
+	set.require(65);
+	set.require(2);
+	std::vector<std::size_t> missing;
+	set.missing_required(bits_of({}), missing);
+	CHECK(missing == std::vector<std::size_t>{2, 65});
+	missing.clear();
+	set.missing_required(bits_of({65}), missing);
+	CHECK(missing == std::vector<std::size_t>{2});
+}
+
+TEST_CASE(truncate_drops_later_groups_and_requirements) {
+	constraint_set set;
+	set.require(1);
+	set.add_group(constraint_set::kind::at_least_one, {1});
+	set.require(70);
+	set.add_group(constraint_set::kind::at_least_one, {70});
+	set.truncate(1, 64);
+	CHECK(set.size() == 1);
+	std::vector<std::size_t> missing;
+	set.missing_required(bits_of({}), missing);
+	CHECK(missing == std::vector<std::size_t>{1});
+}
+
+TEST_CASE(a_satisfied_parse_does_not_throw) {
+	argument_parser::requirement_error storage("", {}, {}, {});
+	CHECK(parse({"--name", "n", "--json", "--input", "--tls-key", "--tls-cert", "--port", "1"}, storage) == nullptr);
+}
+
+TEST_CASE(the_error_names_every_violation) {
+	argument_parser::requirement_error storage("", {}, {}, {});
+	auto const *error = parse({"--json", "--csv", "--tls-key", "--port", "1"}, storage);
+	CHECK(error != nullptr);
+	if (error == nullptr) {
+		return;
+	}
+	CHECK(error->missing_arguments() == std::vector<std::string>{"name"});
+	CHECK(error->violated_constraints() == std::vector<std::size_t>{0, 1, 2});
+	std::string const report = error->what();
+	CHECK(report.find("at most one of these may be provided") != std::string::npos);
+	CHECK(report.find("at least one of these must be provided") != std::string::npos);
+	CHECK(report.find("tls-key: also requires [tls-cert]") != std::string::npos);
+}
+
+TEST_CASE(unknown_names_in_a_group_are_rejected) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	register_options(parser);
+	CHECK_THROWS_AS(parser.add_mutually_exclusive_group({"json", "xml"}), std::runtime_error);
+}
@@ -0,0 +1,74 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <diagnostics.hpp>
+#include <fake_parser.hpp>
+
+#include <stdexcept>
+#include <string>
+
+using argument = argument_parser::builder::argument<>;
+using argument_parser::internal::diagnostics;
+
+namespace {
+	std::string parse_error(std::vector<std::string> const &arguments) {
+		argument_parser::v2::fake_parser parser("tool", arguments);
+		argument::start().long_argument("jobs").store<int>().build(parser);
+		argument::start()
+			.long_argument("go")
+			.action([] { throw std::runtime_error("cannot go ${KEY}"); })
+			.build(parser);
+		try {
+			parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention,
+									 &argument_parser::conventions::gnu_equal_argument_convention});
+		} catch (std::runtime_error const &e) {
+			return e.what();
+		}
+		return {};
+	}
+} // namespace
+
+TEST_CASE(entries_render_in_order) {
+	diagnostics failures;
+	CHECK(failures.empty());
+	failures.add(diagnostics::code::convention_rejected, 0, std::string_view("gnu"), std::string_view("no dash"));
+	failures.add(diagnostics::code::action_failed, 1, std::string_view("--jobs"), std::string("bad value ${KEY}"));
+	failures.add(diagnostics::code::dependency_failed, 2, std::string_view("--run"), std::string_view{});
+	CHECK(!failures.empty());
+	CHECK(failures.render() == "Convention \"gnu\" failed with: no dash\n"
+							   "Error: bad value for --jobs\n"
+							   "Error: skipped --run because an action it depends on failed\n");
+}
+
+TEST_CASE(runtime_conventions_are_named_when_rendering) {
+	diagnostics failures;
+	failures.add(diagnostics::code::convention_rejected, 0, argument_parser::conventions::gnu_argument_convention,
+				 std::string("rejected"));
+	auto const expected =
+		"Convention \"" + argument_parser::conventions::gnu_argument_convention.name() + "\" failed with: rejected\n";
+	CHECK(failures.render() == expected);
+}
+
+TEST_CASE(append_moves_and_clear_keeps_nothing) {
+	diagnostics first;
+	diagnostics second;
+	first.add(diagnostics::code::action_failed, 0, std::string_view("a"), std::string_view("one"));
+	second.add(diagnostics::code::action_failed, 1, std::string_view("b"), std::string_view("two"));
+	first.append(std::move(second));
+	CHECK(first.render() == "Error: one\nError: two\n");
+	first.clear();
+	CHECK(first.empty());
+	CHECK(first.render().empty());
+}
+
+TEST_CASE(a_rejected_token_lists_every_convention) {
+	auto const report = parse_error({"stray"});
+	CHECK(report.find("All trials for argument: \n\t\"stray\"") != std::string::npos);
+	CHECK(report.find(argument_parser::conventions::gnu_argument_convention.name()) != std::string::npos);
+	CHECK(report.find(argument_parser::conventions::gnu_equal_argument_convention.name()) != std::string::npos);
+}
+
+TEST_CASE(a_failed_action_names_the_argument) {
+	CHECK(parse_error({"--go"}).find("Error: cannot go for go") != std::string::npos);
+	CHECK(parse_error({"--jobs", "4"}).empty());
+}
@@ -0,0 +1,33 @@
+/* Subcommand plugin for the plugin tests. "send" registers a message option, a dry-run flag and a target; any other
+ * subcommand registers the message option and then fails, to exercise the host's cleanup. */
+#include <plugin_abi.h>
+
+#include <string.h>
+
+static char last_message[256];
+
+static void on_message(void *user_data, const char *value) {
+	(void)user_data;
+	strncpy(last_message, value, sizeof(last_message) - 1);
+}
+
+ARGPARSE_PLUGIN_EXPORT const char *sample_plugin_last_message(void) {
+	return last_message;
+}
+
+ARGPARSE_PLUGIN_EXPORT int argparse_plugin_register(argparse_plugin_host const *host) {
+	if (host->abi_version != ARGPARSE_PLUGIN_ABI_VERSION) {
+		return 1;
+	}
+	if (host->add_option(host->context, "m", "message", "Message to send.", 0, on_message, NULL) != 0) {
+		return 1;
+	}
+	if (strcmp(host->subcommand, "send") != 0) {
+		/* registering the same name twice fails after the first option is in place */
+		return host->add_flag(host->context, NULL, "message", NULL, 0);
+	}
+	if (host->add_flag(host->context, NULL, "dry", "Do not send.", 0) != 0) {
+		return 1;
+	}
+	return host->add_positional(host->context, "target", "Where to send it.", 1, -1, NULL, NULL);
+}
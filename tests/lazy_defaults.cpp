@@ -0,0 +1,56 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+using test_support::parse;
+
+TEST_CASE(factories_run_once_and_only_when_read) {
+	int calls = 0;
+	argument_parser::v2::fake_parser parser("tool", {});
+	argument::start()
+		.long_argument("threads")
+		.store<int>()
+		.default_factory([&calls] {
+			++calls;
+			return 8;
+		})
+		.build(parser);
+	parse(parser);
+	CHECK(calls == 0);
+	CHECK(parser.get_optional<int>("threads") == 8);
+	CHECK(parser.get_optional<int>("threads") == 8);
+	CHECK(calls == 1);
+}
+
+TEST_CASE(a_parsed_value_wins_over_the_default) {
+	int calls = 0;
+	argument_parser::v2::fake_parser parser("tool", {"--threads", "2"});
+	argument::start()
+		.long_argument("threads")
+		.store<int>()
+		.default_factory([&calls] {
+			++calls;
+			return 8;
+		})
+		.build(parser);
+	parse(parser);
+	CHECK(parser.get_optional<int>("threads") == 2);
+	CHECK(calls == 0);
+}
+
+TEST_CASE(defaults_convert_to_the_stored_type) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	argument::start().long_argument("name").store<std::string>().default_value("unnamed").build(parser);
+	argument::start().short_argument("I").append<std::string>().default_value(std::vector<std::string>{"/usr"}).build(
+		parser);
+	argument::start().short_argument("q").flag().default_value(false).build(parser);
+	parse(parser);
+	CHECK(parser.get_optional<std::string>("name") == std::string("unnamed"));
+	CHECK((parser.get_optional<std::vector<std::string>>("I") == std::vector<std::string>{"/usr"}));
+	CHECK(parser.get_optional<bool>("q") == false);
+}
@@ -0,0 +1,147 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <log_ingest.hpp>
+
+#include <cstring>
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+using argument = argument_parser::builder::argument<>;
+
+namespace {
+	struct panicking {};
+} // namespace
+
+template <> struct argument_parser::parsing_traits::parser_trait<panicking> {
+	static panicking parse(std::string const &) {
+		throw 42;
+	}
+};
+
+namespace {
+	argument_parser::ingest::schema make_schema() {
+		argument_parser::ingest::schema options([](argument_parser::v2::base_parser &parser) {
+			argument::start().long_argument("name").store<std::string>().build(parser);
+			argument::start().long_argument("jobs").store<int>().required().build(parser);
+		});
+		options.column<std::string>("name").column<int>("jobs");
+		return options;
+	}
+
+	std::string ingest_csv(std::string_view log, argument_parser::ingest::settings const &config = {}) {
+		std::ostringstream output;
+		argument_parser::ingest::ingest(log, output, make_schema(),
+										{&argument_parser::conventions::gnu_argument_convention}, config);
+		return output.str();
+	}
+
+	std::string numbered_records(int count) {
+		std::string log;
+		for (int i = 0; i < count; ++i) {
+			log += "tool --jobs " + std::to_string(i) + "\n";
+		}
+		return log;
+	}
+
+	// accepts the header and then fails every write
+	class failing_buffer : public std::streambuf {
+	protected:
+		int_type overflow(int_type ch) override {
+			return ++written < 32 ? ch : traits_type::eof();
+		}
+
+	private:
+		int written = 0;
+	};
+
+	std::size_t count_lines(std::string const &text) {
+		std::size_t lines = 0;
+		for (char c : text) {
+			lines += c == '\n' ? 1 : 0;
+		}
+		return lines;
+	}
+} // namespace
+
+TEST_CASE(every_record_becomes_a_row) {
+	auto const csv = ingest_csv("tool --name a --jobs 1\ntool --jobs 2\n");
+	CHECK(csv == "name,jobs,error\na,1,\n,2,\n");
+}
+
+TEST_CASE(failures_are_reported_per_record) {
+	std::ostringstream output;
+	auto const totals =
+		argument_parser::ingest::ingest("tool --name a\ntool --jobs x\ntool --jobs 5\n", output, make_schema(),
+										{&argument_parser::conventions::gnu_argument_convention});
+	CHECK(totals.records == 3);
+	CHECK(totals.errors == 2);
+	auto const csv = output.str();
+	CHECK(csv.substr(csv.rfind('\n', csv.size() - 2) + 1) == ",5,\n");
+}
+
+TEST_CASE(nul_delimited_records_and_small_chunks) {
+	argument_parser::ingest::settings config;
+	config.records = argument_parser::ingest::record_format::nul_delimited;
+	config.chunk_bytes = 8;
+	config.max_threads = 3;
+	std::string log;
+	for (int i = 0; i < 50; ++i) {
+		log += "tool --jobs " + std::to_string(i);
+		log += '\0';
+	}
+	auto const csv = ingest_csv(log, config);
+	CHECK(count_lines(csv) == 51);
+	CHECK(csv.find(",49,\n") != std::string::npos);
+	CHECK(csv.find("\n,0,\n") != std::string::npos);
+}
+
+TEST_CASE(binary_output_starts_with_the_column_header) {
+	argument_parser::ingest::settings config;
+	config.output = argument_parser::ingest::output_format::binary;
+	auto const table = ingest_csv("tool --jobs 7\n", config);
+	CHECK(table.compare(0, 8, "APCOLS01") == 0);
+	std::uint32_t columns = 0;
+	std::memcpy(&columns, table.data() + 8, sizeof(columns));
+	CHECK(columns == 3);
+}
+
+TEST_CASE(a_throwing_schema_is_rethrown_after_the_workers_stop) {
+	argument_parser::ingest::schema broken([](argument_parser::v2::base_parser &) {
+		throw std::runtime_error("no schema");
+	});
+	argument_parser::ingest::settings config;
+	config.chunk_bytes = 16;
+	config.max_threads = 4;
+	std::ostringstream output;
+	CHECK_THROWS_AS(argument_parser::ingest::ingest(numbered_records(40), output, broken,
+													{&argument_parser::conventions::gnu_argument_convention}, config),
+					std::runtime_error);
+}
+
+TEST_CASE(exceptions_of_any_type_are_rethrown) {
+	argument_parser::ingest::schema options([](argument_parser::v2::base_parser &parser) {
+		argument::start().long_argument("jobs").store<int>().build(parser);
+		argument::start().long_argument("panic").store<panicking>().build(parser);
+	});
+	options.column<int>("jobs");
+	std::ostringstream output;
+	CHECK_THROWS_AS(argument_parser::ingest::ingest("tool --jobs 1\ntool --panic now\n", output, options,
+													{&argument_parser::conventions::gnu_argument_convention}),
+					int);
+}
+
+TEST_CASE(a_failing_output_stops_the_workers) {
+	argument_parser::ingest::settings config;
+	config.chunk_bytes = 16;
+	config.max_threads = 2;
+	failing_buffer buffer;
+	std::ostream output(&buffer);
+	output.exceptions(std::ios::badbit);
+	CHECK_THROWS_AS(argument_parser::ingest::ingest(numbered_records(400), output, make_schema(),
+													{&argument_parser::conventions::gnu_argument_convention}, config),
+					std::ios::failure);
+}
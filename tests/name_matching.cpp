@@ -0,0 +1,76 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <stdexcept>
+#include <string>
+
+using argument = argument_parser::builder::argument<>;
+using argument_parser::name_matching;
+namespace static_dispatch = argument_parser::conventions::static_dispatch;
+
+namespace {
+	struct tool {
+		argument_parser::v2::fake_parser parser;
+
+		tool(std::vector<std::string> const &arguments, name_matching matching) : parser("tool", arguments) {
+			argument::start().long_argument("verbose").flag().build(parser);
+			argument::start().long_argument("version").flag().build(parser);
+			argument::start().long_argument("verb").store<std::string>().build(parser);
+			argument::start().long_argument("level").short_argument("L").store<int>().build(parser);
+			parser.set_long_name_matching(matching);
+		}
+
+		std::string error() {
+			try {
+				parser.handle_arguments<static_dispatch::gnu>();
+			} catch (std::runtime_error const &e) {
+				return e.what();
+			}
+			return {};
+		}
+	};
+} // namespace
+
+TEST_CASE(unique_prefixes_select_their_option) {
+	tool t({"--verbo", "--vers"}, {false, true});
+	CHECK(t.error().empty());
+	CHECK(t.parser.get_optional<bool>("verbose") == true);
+	CHECK(t.parser.get_optional<bool>("version") == true);
+}
+
+TEST_CASE(an_exact_spelling_wins_over_longer_names) {
+	tool t({"--verb", "x"}, {false, true});
+	CHECK(t.error().empty());
+	CHECK(t.parser.get_optional<std::string>("verb") == std::string("x"));
+	CHECK(!t.parser.get_optional<bool>("verbose").has_value());
+}
+
+TEST_CASE(ambiguous_prefixes_list_every_candidate) {
+	tool t({"--ver"}, {false, true});
+	CHECK(t.error().find("Ambiguous argument: ver could be any of verb, verbose, version") != std::string::npos);
+}
+
+TEST_CASE(case_folding_is_opt_in_for_gnu_tokens) {
+	tool folded({"--VERBOSE", "--LEV", "4"}, {true, true});
+	CHECK(folded.error().empty());
+	CHECK(folded.parser.get_optional<bool>("verbose") == true);
+	CHECK(folded.parser.get_optional<int>("level") == 4);
+
+	tool exact({"--VERBOSE"}, {false, false});
+	CHECK(exact.error().find("Unknown argument: VERBOSE") != std::string::npos);
+	tool no_prefix({"--verbo"}, {false, false});
+	CHECK(no_prefix.error().find("Unknown argument: verbo") != std::string::npos);
+}
+
+TEST_CASE(windows_tokens_always_ignore_case) {
+	tool t({"/LEVEL", "5", "/Verbose"}, {});
+	t.parser.handle_arguments<static_dispatch::windows<>>();
+	CHECK(t.parser.get_optional<int>("level") == 5);
+	CHECK(t.parser.get_optional<bool>("verbose") == true);
+
+	tool short_name({"/l", "6"}, {});
+	short_name.parser.handle_arguments<static_dispatch::windows<>>();
+	CHECK(short_name.parser.get_optional<int>("level") == 6);
+}
@@ -0,0 +1,104 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+
+namespace {
+	int deploys = 0;
+
+	void parse(argument_parser::v2::fake_parser &parser, std::vector<std::string> const &arguments) {
+		parser.set_parsed_arguments(arguments);
+		parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	}
+
+	void add_commands(argument_parser::v2::fake_parser &parser) {
+		argument::start().long_argument("verbose").build(parser);
+		parser.add_subcommand("build", "Build.", [](argument_parser::v2::base_parser &p) {
+			argument::start().long_argument("jobs").store<int>().build(p);
+			argument::start().long_argument("deploy").action([] { ++deploys; }).build(p);
+		});
+		parser.add_subcommand("test", "Test.", [](argument_parser::v2::base_parser &p) {
+			argument::start().long_argument("filter").store<std::string>().build(p);
+		});
+	}
+} // namespace
+
+TEST_CASE(a_repeated_command_line_is_a_hit) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	argument::start().long_argument("port").store<int>().build(parser);
+	parser.set_parse_cache(4);
+	parse(parser, {"--port", "80"});
+	parse(parser, {"--port", "81"});
+	parse(parser, {"--port", "80"});
+	CHECK(parser.get_optional<int>("port") == 80);
+	auto const stats = parser.parse_cache_stats();
+	CHECK(stats.hits == 1);
+	CHECK(stats.misses == 2);
+	CHECK(stats.entries == 2);
+}
+
+TEST_CASE(a_hit_selects_the_cached_subcommand_again) {
+	deploys = 0;
+	argument_parser::v2::fake_parser parser("tool", {});
+	add_commands(parser);
+	parser.set_parse_cache(4);
+	parse(parser, {"build", "--jobs", "3", "--deploy"});
+	parse(parser, {"test", "--filter", "unit"});
+	CHECK(parser.get_optional<std::string>("filter") == std::string("unit"));
+	parse(parser, {"build", "--jobs", "3", "--deploy"});
+	CHECK(parser.parse_cache_stats().hits == 1);
+	CHECK(parser.subcommand_path() == std::vector<std::string>{"build"});
+	CHECK(parser.get_optional<int>("jobs") == 3);
+	CHECK(deploys == 2);
+	parse(parser, {"test", "--filter", "unit"});
+	CHECK(parser.parse_cache_stats().hits == 2);
+	CHECK(parser.subcommand_path() == std::vector<std::string>{"test"});
+	CHECK(parser.get_optional<std::string>("filter") == std::string("unit"));
+}
+
+TEST_CASE(registering_invalidates_cached_parses) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	argument::start().positional("target").store<std::string>().build(parser);
+	parser.set_parse_cache(4);
+	parse(parser, {"deploy"});
+	CHECK(parser.get_optional<std::string>("target") == std::string("deploy"));
+
+	parser.add_subcommand("deploy", "Deploy.", [](argument_parser::v2::base_parser &) {});
+	parse(parser, {"deploy"});
+	CHECK(parser.parse_cache_stats().hits == 0);
+	CHECK(parser.subcommand_path() == std::vector<std::string>{"deploy"});
+	CHECK(!parser.get_optional<std::string>("target").has_value());
+}
+
+TEST_CASE(a_factory_registering_differently_makes_a_miss) {
+	int runs = 0;
+	argument_parser::v2::fake_parser parser("tool", {});
+	parser.add_subcommand("run", "Run.", [&runs](argument_parser::v2::base_parser &p) {
+		argument::start().long_argument("level").store<int>().build(p);
+		if (++runs > 1) {
+			argument::start().long_argument("extra").build(p);
+		}
+	});
+	parser.set_parse_cache(4);
+	parse(parser, {"run", "--level", "2"});
+	parse(parser, {"run", "--level", "2"});
+	CHECK(parser.get_optional<int>("level") == 2);
+	CHECK(parser.subcommand_path() == std::vector<std::string>{"run"});
+	CHECK(runs == 3); // selected for the hit, rolled back, selected again by the full parse
+}
+
+TEST_CASE(actions_are_not_replayed_when_disabled) {
+	deploys = 0;
+	argument_parser::v2::fake_parser parser("tool", {});
+	add_commands(parser);
+	parser.set_parse_cache(4, false);
+	parse(parser, {"build", "--deploy"});
+	parse(parser, {"build", "--deploy"});
+	CHECK(parser.parse_cache_stats().hits == 1);
+	CHECK(deploys == 1);
+}
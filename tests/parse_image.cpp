@@ -0,0 +1,113 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+#include <parse_image.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using argument = argument_parser::builder::argument<>;
+
+namespace {
+	struct point {
+		int x;
+		int y;
+	};
+} // namespace
+
+template <> struct argument_parser::parsing_traits::parser_trait<point> {
+	static point parse(std::string const &input) {
+		auto const comma = input.find(',');
+		return {std::stoi(input.substr(0, comma)), std::stoi(input.substr(comma + 1))};
+	}
+};
+
+static_assert(argument_parser::image::detail::representable<std::vector<double>>());
+static_assert(!argument_parser::image::detail::representable<std::string_view>());
+static_assert(!argument_parser::image::detail::representable<point>());
+
+namespace {
+	int action_calls = 0;
+
+	void schema(argument_parser::v2::base_parser &parser) {
+		argument::start().long_argument("port").store<int>().build(parser);
+		argument::start().long_argument("name").store<std::string>().build(parser);
+		argument::start().long_argument("tag").append<std::string>().build(parser);
+		argument::start().short_argument("v").count().build(parser);
+		argument::start().long_argument("go").action([] { ++action_calls; }).build(parser);
+		argument::start().positional("file").store<std::string>().build(parser);
+	}
+
+	std::string saved_image() {
+		argument_parser::v2::fake_parser parser(
+			"tool", {"--port", "80", "--name", "svc", "--tag", "a", "--tag", "bb", "-vv", "--go", "in.txt"});
+		schema(parser);
+		parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+		return parser.save_image();
+	}
+} // namespace
+
+TEST_CASE(an_image_restores_every_stored_value) {
+	auto const image = saved_image();
+	action_calls = 0;
+	argument_parser::v2::fake_parser parser("tool", {});
+	schema(parser);
+	parser.load_image(image);
+	CHECK(action_calls == 0);
+	CHECK(parser.get_optional<int>("port") == 80);
+	CHECK(parser.get_optional<std::string>("name") == std::string("svc"));
+	CHECK(parser.get_optional<std::vector<std::string>>("tag") == std::vector<std::string>{"a", "bb"});
+	CHECK(parser.get_optional<int>("v") == 2);
+	CHECK(parser.get_optional<std::string>("file") == std::string("in.txt"));
+}
+
+TEST_CASE(saving_is_deterministic) {
+	CHECK(saved_image() == saved_image());
+}
+
+TEST_CASE(a_different_schema_is_rejected) {
+	auto const image = saved_image();
+	argument_parser::v2::fake_parser parser("tool", {});
+	schema(parser);
+	argument::start().long_argument("extra").flag().build(parser);
+	CHECK_THROWS_AS(parser.load_image(image), std::runtime_error);
+}
+
+TEST_CASE(a_truncated_image_is_rejected) {
+	auto const image = saved_image();
+	argument_parser::v2::fake_parser parser("tool", {});
+	schema(parser);
+	CHECK_THROWS_AS(parser.load_image(std::string_view(image).substr(0, image.size() / 2)), std::runtime_error);
+}
+
+TEST_CASE(other_types_are_recorded_as_invoked_only) {
+	argument_parser::v2::fake_parser saved("tool", {"--at", "1,2"});
+	argument::start().long_argument("at").store<point>().build(saved);
+	saved.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(saved.get_optional<point>("at").has_value());
+	auto const image = saved.save_image();
+
+	argument_parser::v2::fake_parser loaded("tool", {});
+	argument::start().long_argument("at").store<point>().build(loaded);
+	loaded.load_image(image);
+	CHECK(!loaded.get_optional<point>("at").has_value());
+}
+
+#ifdef __linux__
+TEST_CASE(an_image_survives_a_memfd) {
+	int const fd = argument_parser::image::to_memfd(saved_image());
+	CHECK(fd >= 0);
+	argument_parser::image::mapped_image mapped(fd);
+	::close(fd); // the mapping outlives the descriptor
+	argument_parser::v2::fake_parser parser("tool", {});
+	schema(parser);
+	parser.load_image(mapped.bytes());
+	CHECK(parser.get_optional<int>("port") == 80);
+}
+#endif
@@ -0,0 +1,113 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+#include <plugin_registry.hpp>
+
+#include <dlfcn.h>
+#include <stdexcept>
+#include <string>
+
+#ifndef SAMPLE_PLUGIN_PATH
+#error "SAMPLE_PLUGIN_PATH must name the sample plugin fixture"
+#endif
+
+namespace {
+	// a handle to the fixture only while something else keeps it loaded
+	class loaded_plugin {
+	public:
+		loaded_plugin() : handle(::dlopen(SAMPLE_PLUGIN_PATH, RTLD_NOW | RTLD_NOLOAD)) {}
+		~loaded_plugin() {
+			if (handle != nullptr) {
+				::dlclose(handle);
+			}
+		}
+
+		loaded_plugin(loaded_plugin const &) = delete;
+		loaded_plugin &operator=(loaded_plugin const &) = delete;
+
+		explicit operator bool() const {
+			return handle != nullptr;
+		}
+
+		std::string last_message() const {
+			auto query = reinterpret_cast<const char *(*)()>(::dlsym(handle, "sample_plugin_last_message"));
+			return query();
+		}
+
+	private:
+		void *handle;
+	};
+
+	void parse(argument_parser::v2::fake_parser &parser, std::vector<std::string> const &arguments) {
+		parser.set_parsed_arguments(arguments);
+		parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	}
+} // namespace
+
+TEST_CASE(library_is_loaded_only_when_its_subcommand_is_selected) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	argument_parser::plugins::plugin_registry plugins;
+	plugins.add("send", SAMPLE_PLUGIN_PATH, "Send a message.");
+	plugins.install(parser);
+
+	parse(parser, {});
+	CHECK(!loaded_plugin());
+
+	parse(parser, {"send", "-m", "hello", "--dry", "home"});
+	CHECK(parser.subcommand_path() == std::vector<std::string>{"send"});
+	CHECK(parser.get_optional<bool>("dry") == true);
+	CHECK(parser.get_optional<std::string>("target") == std::string("home"));
+	loaded_plugin plugin;
+	CHECK(static_cast<bool>(plugin));
+	CHECK(plugin.last_message() == "hello");
+}
+
+TEST_CASE(actions_keep_the_library_loaded) {
+	argument_parser::v2::fake_parser parser("tool", {"-m", "kept", "away"});
+	argument_parser::plugins::load_plugin(parser, "send", SAMPLE_PLUGIN_PATH);
+	CHECK(static_cast<bool>(loaded_plugin()));
+
+	// the loader's own reference is gone; the callbacks still run from the library
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	loaded_plugin plugin;
+	CHECK(plugin.last_message() == "kept");
+}
+
+TEST_CASE(the_library_is_loaded_once_for_the_parsers_lifetime) {
+	{
+		argument_parser::v2::fake_parser parser("tool", {});
+		argument_parser::plugins::add_plugin_subcommand(parser, "send", SAMPLE_PLUGIN_PATH);
+		parse(parser, {"send", "-m", "first", "home"});
+		CHECK(static_cast<bool>(loaded_plugin()));
+
+		// a reloaded library would have lost the message recorded by the first parse
+		parse(parser, {"send", "home"});
+		CHECK(parser.get_optional<std::string>("target") == std::string("home"));
+		loaded_plugin plugin;
+		CHECK(plugin.last_message() == "first");
+	}
+	CHECK(!loaded_plugin());
+}
+
+TEST_CASE(a_failing_entry_point_leaves_the_parser_as_it_was) {
+	argument_parser::v2::fake_parser parser("tool", {"-m", "x"});
+	CHECK_THROWS_AS(argument_parser::plugins::load_plugin(parser, "broken", SAMPLE_PLUGIN_PATH), std::runtime_error);
+	CHECK(!parser.to_v1().find_argument_id("message").has_value());
+	CHECK(!loaded_plugin());
+
+	// the names are free again
+	argument_parser::plugins::load_plugin(parser, "send", SAMPLE_PLUGIN_PATH);
+	CHECK(parser.to_v1().find_argument_id("message").has_value());
+}
+
+TEST_CASE(missing_libraries_and_entry_points_are_reported) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	CHECK_THROWS_AS(argument_parser::plugins::load_plugin(parser, "send", "/nonexistent/libplugin.so"),
+					std::runtime_error);
+	argument_parser::plugins::plugin_registry plugins;
+	plugins.add("send", SAMPLE_PLUGIN_PATH);
+	CHECK_THROWS_AS(plugins.add("send", SAMPLE_PLUGIN_PATH), std::runtime_error);
+	CHECK(plugins.find("send").has_value());
+	CHECK(!plugins.find("receive").has_value());
+}
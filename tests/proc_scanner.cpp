@@ -0,0 +1,87 @@
+// Run with: --mode scan input.txt
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+#include <proc_scanner.hpp>
+
+#include <string>
+#include <unistd.h>
+
+using argument = argument_parser::builder::argument<>;
+
+namespace {
+	void schema(argument_parser::v2::base_parser &parser) {
+		argument::start().long_argument("mode").store<std::string>().build(parser);
+		argument::start().positional("input").store<std::string>().build(parser);
+	}
+
+	void strict_schema(argument_parser::v2::base_parser &parser) {
+		schema(parser);
+		argument::start().long_argument("config").store<std::string>().required().build(parser);
+	}
+} // namespace
+
+TEST_CASE(the_reader_returns_argv_of_a_process) {
+	argument_parser::proc::cmdline_reader reader;
+	CHECK(reader.read(::getpid()));
+	auto const &tokens = reader.tokens();
+	CHECK(tokens.size() == 4);
+	CHECK(reader.program() == tokens.front());
+	CHECK(tokens[1] == "--mode");
+	CHECK(tokens[3] == "input.txt");
+}
+
+TEST_CASE(a_process_is_parsed_against_the_schema) {
+	argument_parser::proc::cmdline_reader reader;
+	argument_parser::proc::scan_result result;
+	CHECK(argument_parser::proc::parse_process(::getpid(), schema,
+											   {&argument_parser::conventions::gnu_argument_convention}, reader,
+											   result));
+	CHECK(result.error.empty());
+	CHECK(result.parsed != nullptr);
+	CHECK(result.parsed->get_optional<std::string>("mode") == std::string("scan"));
+	CHECK(result.parsed->get_optional<std::string>("input") == std::string("input.txt"));
+}
+
+TEST_CASE(a_missing_required_argument_is_reported_per_process) {
+	argument_parser::proc::cmdline_reader reader;
+	argument_parser::proc::scan_result result;
+	CHECK(argument_parser::proc::parse_process(::getpid(), strict_schema,
+											   {&argument_parser::conventions::gnu_argument_convention}, reader,
+											   result));
+	CHECK(result.parsed == nullptr);
+	CHECK(result.error.find("--config") != std::string::npos);
+}
+
+TEST_CASE(scan_finds_this_process_by_name) {
+	argument_parser::proc::scan_options settings;
+	settings.filter = argument_parser::proc::program_named("test_proc_scanner");
+	settings.max_threads = 2;
+	auto const results =
+		argument_parser::proc::scan(strict_schema, {&argument_parser::conventions::gnu_argument_convention}, settings);
+	bool found = false;
+	for (auto const &result : results) {
+		if (result.pid == ::getpid()) {
+			found = true;
+			CHECK(!result.error.empty());
+		}
+	}
+	CHECK(found);
+}
+
+TEST_CASE(a_fake_parser_throws_a_requirement_error_when_asked_not_to_exit) {
+	argument_parser::v2::fake_parser parser("tool", {"--mode", "scan"});
+	strict_schema(parser);
+	parser.exit_on_requirement_errors(false);
+	bool thrown = false;
+	try {
+		parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	} catch (argument_parser::requirement_error const &e) {
+		thrown = true;
+		CHECK(e.missing().size() == 1);
+		CHECK(e.missing_arguments() == std::vector<std::string>{"config"});
+		CHECK(e.violated_constraints().empty());
+	}
+	CHECK(thrown);
+}
@@ -0,0 +1,41 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+using test_support::parse;
+
+TEST_CASE(append_collects_every_occurrence_in_order) {
+	argument_parser::v2::fake_parser parser("tool", {"-I", "a", "--include", "b", "-I", "c", "-n", "1", "-n", "2"});
+	argument::start().short_argument("I").long_argument("include").append<std::string>().build(parser);
+	argument::start().short_argument("n").append<int>().build(parser);
+	parse(parser);
+	CHECK((parser.get_optional<std::vector<std::string>>("include") == std::vector<std::string>{"a", "b", "c"}));
+	CHECK((parser.get_optional<std::vector<int>>("n") == std::vector<int>{1, 2}));
+}
+
+TEST_CASE(count_adds_up_bundles_and_repeats) {
+	argument_parser::v2::fake_parser parser("tool", {"-vvv", "-v", "--verbose"});
+	argument::start().short_argument("v").long_argument("verbose").count().build(parser);
+	parse(parser);
+	CHECK(parser.get_optional<int>("v") == 5);
+}
+
+TEST_CASE(absent_repeated_options_have_no_value) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	argument::start().short_argument("I").append<std::string>().build(parser);
+	argument::start().short_argument("v").count().build(parser);
+	parse(parser);
+	CHECK(!parser.get_optional<std::vector<std::string>>("I").has_value());
+}
+
+TEST_CASE(a_plain_store_keeps_the_last_occurrence) {
+	argument_parser::v2::fake_parser parser("tool", {"--level", "1", "--level", "3"});
+	argument::start().long_argument("level").store<int>().build(parser);
+	parse(parser);
+	CHECK(parser.get_optional<int>("level") == 3);
+}
@@ -0,0 +1,103 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+#include <small_function.hpp>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+using argument = argument_parser::builder::argument<>;
+using callback = argument_parser::internal::small_function<int(int)>;
+
+static_assert(!std::is_copy_constructible_v<argument_parser::base_parser>);
+static_assert(!std::is_copy_assignable_v<argument_parser::base_parser>);
+static_assert(!std::is_move_constructible_v<argument_parser::base_parser>);
+static_assert(!std::is_move_assignable_v<argument_parser::base_parser>);
+static_assert(!std::is_copy_constructible_v<callback>);
+static_assert(!std::is_copy_constructible_v<argument_parser::parametered_action<int>>);
+static_assert(std::is_nothrow_move_constructible_v<callback>);
+
+namespace {
+	int twice(int value) {
+		return value * 2;
+	}
+} // namespace
+
+TEST_CASE(small_callables_are_stored_inline) {
+	callback from_function = twice;
+	callback from_pointer = &twice;
+	int offset = 3;
+	callback from_lambda = [offset](int value) { return value + offset; };
+	callback from_std_function = std::function<int(int)>(twice);
+	CHECK(from_function(4) == 8);
+	CHECK(from_pointer(4) == 8);
+	CHECK(from_lambda(4) == 7);
+	CHECK(from_std_function(5) == 10);
+	CHECK(from_function.is_inline() && from_pointer.is_inline() && from_lambda.is_inline());
+	CHECK(from_std_function.is_inline());
+}
+
+TEST_CASE(large_callables_go_to_the_heap_and_survive_moves) {
+	std::array<int, 32> table{};
+	table[5] = 42;
+	callback lookup = [table](int index) { return table[static_cast<std::size_t>(index)]; };
+	CHECK(!lookup.is_inline());
+	callback moved = std::move(lookup);
+	CHECK(moved(5) == 42);
+	CHECK(!lookup);
+	callback assigned;
+	assigned = std::move(moved);
+	CHECK(assigned(5) == 42);
+}
+
+TEST_CASE(move_only_callables_are_accepted) {
+	callback owning = [held = std::make_unique<int>(7)](int value) { return *held + value; };
+	callback moved = std::move(owning);
+	CHECK(moved(1) == 8);
+}
+
+TEST_CASE(null_and_empty_targets_stay_empty) {
+	int (*none)(int) = nullptr;
+	callback from_null = none;
+	callback from_empty = std::function<int(int)>();
+	CHECK(!from_null);
+	CHECK(!from_empty);
+	CHECK_THROWS_AS(from_null(1), std::bad_function_call);
+}
+
+TEST_CASE(registration_moves_the_action_without_copying_it) {
+	auto calls = std::make_shared<int>(0);
+	argument_parser::v2::fake_parser parser("tool", {"--go"});
+	argument::start().long_argument("go").action([calls] { ++*calls; }).build(parser);
+	// the lambda was moved from the builder into the registered action: one owner besides this one
+	CHECK(calls.use_count() == 2);
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(*calls == 1);
+}
+
+TEST_CASE(a_copied_builder_shares_its_action) {
+	int calls = 0;
+	argument_parser::v2::fake_parser first("tool", {"--go"});
+	argument_parser::v2::fake_parser second("tool", {"--go"});
+	auto go = argument::start().long_argument("go").action([&calls] { ++calls; });
+	auto copy = go;
+	std::move(copy).build(first);
+	std::move(go).build(second);
+	first.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	second.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(calls == 2);
+}
+
+TEST_CASE(registered_actions_are_not_copied_per_parse) {
+	auto calls = std::make_shared<int>(0);
+	argument_parser::v2::fake_parser parser("tool", {"--go", "--go"});
+	argument::start().long_argument("go").action([calls] { ++*calls; }).build(parser);
+	auto const owners = calls.use_count();
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(*calls == 2);
+	CHECK(calls.use_count() == owners);
+}
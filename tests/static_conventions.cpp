@@ -0,0 +1,71 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+namespace static_dispatch = argument_parser::conventions::static_dispatch;
+using argument_parser::conventions::argument_type;
+
+static_assert(static_dispatch::gnu::classify("--name").type == argument_type::LONG);
+static_assert(static_dispatch::gnu::classify("-n").name == "n");
+static_assert(static_dispatch::gnu::classify("name").type == argument_type::ERROR);
+static_assert(static_dispatch::gnu_equal::classify("--x=3").value == "3");
+static_assert(!static_dispatch::gnu_equal::classify("--x=").has_value);
+static_assert(static_dispatch::windows_kv<true>::classify("/Opt:v").name == "Opt");
+static_assert(static_dispatch::windows<false>::classify("-opt").type == argument_type::ERROR);
+
+namespace {
+	void register_schema(argument_parser::v2::fake_parser &parser) {
+		argument::start().long_argument("port").store<int>().build(parser);
+		argument::start().short_argument("v").flag().build(parser);
+		argument::start().long_argument("name").store<std::string>().build(parser);
+		argument::start().long_argument("level").store<int>().build(parser);
+		argument::start().positional("file").store<std::string>().build(parser);
+	}
+
+	std::vector<std::string> const tokens{"--port=80", "-v", "--name", "x", "/Level", "3", "input"};
+} // namespace
+
+TEST_CASE(static_and_runtime_conventions_agree) {
+	argument_parser::v2::fake_parser with_static("tool", tokens);
+	register_schema(with_static);
+	with_static.handle_arguments<static_dispatch::gnu_equal, static_dispatch::gnu, static_dispatch::windows<>>();
+
+	argument_parser::v2::fake_parser with_runtime("tool", tokens);
+	register_schema(with_runtime);
+	with_runtime.handle_arguments({&argument_parser::conventions::gnu_equal_argument_convention,
+								   &argument_parser::conventions::gnu_argument_convention,
+								   &argument_parser::conventions::windows_argument_convention});
+
+	for (auto *parser : {&with_static, &with_runtime}) {
+		CHECK(parser->get_optional<int>("port") == 80);
+		CHECK(parser->get_optional<bool>("v") == true);
+		CHECK(parser->get_optional<std::string>("name") == std::string("x"));
+		CHECK(parser->get_optional<int>("level") == 3);
+		CHECK(parser->get_optional<std::string>("file") == std::string("input"));
+	}
+}
+
+TEST_CASE(unknown_options_fail_with_every_convention_tried) {
+	argument_parser::v2::fake_parser parser("tool", {"--bad"});
+	try {
+		parser.handle_arguments<static_dispatch::gnu, static_dispatch::windows_kv<>>();
+		CHECK(false);
+	} catch (std::runtime_error const &e) {
+		std::string const message = e.what();
+		CHECK(message.find("--bad") != std::string::npos);
+		CHECK(message.find(std::string(static_dispatch::windows_kv<>::name)) != std::string::npos);
+	}
+}
+
+TEST_CASE(adapters_render_help_like_the_convention) {
+	auto const help =
+		static_dispatch::runtime_convention<static_dispatch::windows_kv<>>.make_help_text("o", "opt", true);
+	CHECK(help.second.find(":<value>") != std::string::npos);
+	CHECK(static_dispatch::runtime_convention<static_dispatch::gnu>.requires_next_token());
+}
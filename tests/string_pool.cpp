@@ -0,0 +1,62 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+#include <string_pool.hpp>
+
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+
+TEST_CASE(equal_strings_are_stored_once) {
+	argument_parser::internal::string_pool pool;
+	std::string first = "Prints more.";
+	std::string second = first;
+	auto const a = pool.intern(first);
+	auto const b = pool.intern(second);
+	CHECK(a == "Prints more.");
+	CHECK(a.data() == b.data());
+	CHECK(a.data() != first.data());
+	CHECK(pool.size() == 1);
+}
+
+TEST_CASE(views_stay_valid_as_the_pool_grows) {
+	argument_parser::internal::string_pool pool;
+	std::vector<std::string_view> views;
+	for (int i = 0; i < 5000; ++i) {
+		views.push_back(pool.intern("option-" + std::to_string(i)));
+	}
+	views.push_back(pool.intern(std::string(20000, 'x')));
+	for (int i = 0; i < 5000; ++i) {
+		CHECK(views[static_cast<std::size_t>(i)] == "option-" + std::to_string(i));
+	}
+	CHECK(views.back() == std::string(20000, 'x'));
+	CHECK(pool.size() == 5001);
+	CHECK(pool.bytes() > 20000);
+}
+
+TEST_CASE(copies_are_concatenated_and_not_shared) {
+	argument_parser::internal::string_pool pool;
+	auto const a = pool.copy({"v", "|", "verbose"});
+	auto const b = pool.copy({"v", "|", "verbose"});
+	CHECK(a == "v|verbose");
+	CHECK(a.data() != b.data());
+	CHECK(pool.intern("") == "");
+	CHECK(pool.size() == 3);
+}
+
+TEST_CASE(the_parser_keeps_its_own_copy_of_schema_strings) {
+	argument_parser::v2::fake_parser parser("tool", {"--level", "3"});
+	{
+		std::string name = "level";
+		std::string help = "How loud to be.";
+		argument::start().long_argument(name).help_text(help).store<int>().build(parser);
+		name.assign(name.size(), '#');
+		help.assign(help.size(), '#');
+	}
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(parser.get_optional<int>("level") == 3);
+	auto const help = parser.to_v1().build_help_text({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(help.find("How loud to be.") != std::string::npos);
+}
@@ -0,0 +1,111 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <stdexcept>
+#include <string>
+
+using argument = argument_parser::builder::argument<>;
+
+namespace {
+	struct tool {
+		argument_parser::v2::fake_parser parser{"tool", {}};
+		int build_factories = 0;
+		int test_factories = 0;
+
+		tool() {
+			argument::start().short_argument("v").flag().build(parser);
+			parser.add_subcommand("build", "Build the project.", [this](argument_parser::v2::base_parser &p) {
+				++build_factories;
+				argument::start().long_argument("jobs").store<int>().build(p);
+			});
+			parser.add_subcommand("test", "Run the tests.", [this](argument_parser::v2::base_parser &p) {
+				++test_factories;
+				argument::start().long_argument("filter").store<int>().build(p);
+				p.add_subcommand("unit", "Unit tests only.", [](argument_parser::v2::base_parser &q) {
+					argument::start().long_argument("shard").store<int>().build(q);
+				});
+			});
+		}
+
+		void parse(std::vector<std::string> const &arguments) {
+			parser.set_parsed_arguments(arguments);
+			parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+		}
+
+		std::string help() {
+			return parser.to_v1().build_help_text({&argument_parser::conventions::gnu_argument_convention});
+		}
+	};
+} // namespace
+
+TEST_CASE(first_positional_token_selects_the_factory) {
+	tool t;
+	t.parse({"-v", "build", "--jobs", "4"});
+	CHECK(t.build_factories == 1);
+	CHECK(t.test_factories == 0);
+	CHECK(t.parser.subcommand_path() == std::vector<std::string>{"build"});
+	CHECK(t.parser.get_optional<int>("jobs") == 4);
+	CHECK(t.parser.get_optional<bool>("v") == true);
+}
+
+TEST_CASE(the_next_parse_undoes_the_selection) {
+	tool t;
+	t.parse({"build", "--jobs", "3"});
+	t.parse({"build", "--jobs", "5"});
+	CHECK(t.build_factories == 2);
+	CHECK(t.parser.get_optional<int>("jobs") == 5);
+
+	t.parse({"-v"});
+	CHECK(t.parser.subcommand_path().empty());
+	CHECK(!t.parser.to_v1().find_argument_id("jobs").has_value());
+}
+
+TEST_CASE(nested_levels_are_selected_and_rolled_back) {
+	tool t;
+	t.parse({"test", "unit", "--shard", "7", "--filter", "1"});
+	CHECK((t.parser.subcommand_path() == std::vector<std::string>{"test", "unit"}));
+	CHECK(t.parser.get_optional<int>("shard") == 7);
+
+	t.parse({"build"});
+	CHECK(t.parser.subcommand_path() == std::vector<std::string>{"build"});
+	CHECK(!t.parser.to_v1().find_argument_id("shard").has_value());
+	CHECK(!t.parser.to_v1().find_argument_id("filter").has_value());
+}
+
+TEST_CASE(only_the_first_positional_token_selects) {
+	argument_parser::v2::fake_parser parser("tool", {"input", "build"});
+	argument::start().positional("first").build(parser);
+	argument::start().positional("second").build(parser);
+	int factories = 0;
+	parser.add_subcommand("build", "Build.", [&factories](argument_parser::v2::base_parser &) { ++factories; });
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(factories == 0);
+	CHECK(parser.subcommand_path().empty());
+	CHECK(parser.get_optional<std::string>("second") == std::string("build"));
+}
+
+TEST_CASE(help_after_a_selection_keeps_the_commands) {
+	tool t;
+	CHECK(t.help().find("Commands:") != std::string::npos);
+	t.parse({"build"});
+	auto const help = t.help();
+	CHECK(help.find("Usage: tool build [OPTIONS]") != std::string::npos);
+	CHECK(help.find("Commands:") != std::string::npos);
+	CHECK(help.find("Run the tests.") != std::string::npos);
+	CHECK(help.find("--jobs") != std::string::npos);
+}
+
+TEST_CASE(constraints_of_a_factory_are_rolled_back) {
+	argument_parser::v2::fake_parser parser("tool", {"strict", "--a", "1"});
+	parser.add_subcommand("strict", "Needs --a.", [](argument_parser::v2::base_parser &p) {
+		argument::start().long_argument("a").store<int>().required().build(p);
+	});
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(parser.get_optional<int>("a") == 1);
+
+	parser.set_parsed_arguments({});
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(parser.subcommand_path().empty());
+}
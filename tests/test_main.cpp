@@ -0,0 +1,5 @@
+#include "test_support.hpp"
+
+auto main() -> int {
+	return test_support::run_all();
+}
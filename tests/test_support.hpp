@@ -0,0 +1,76 @@
+#pragma once
+#ifndef ARGUMENT_PARSER_TEST_SUPPORT_HPP
+#define ARGUMENT_PARSER_TEST_SUPPORT_HPP
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <exception>
+#include <iostream>
+#include <vector>
+
+namespace test_support {
+	struct test_case {
+		const char *name;
+		void (*body)();
+	};
+
+	inline std::vector<test_case> &registry() {
+		static std::vector<test_case> cases;
+		return cases;
+	}
+
+	inline int failures = 0;
+
+	struct registrar {
+		registrar(const char *name, void (*body)()) {
+			registry().push_back({name, body});
+		}
+	};
+
+	inline void fail(const char *file, int line, const char *expression) {
+		std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+		++failures;
+	}
+
+	/** @brief Parses the arguments the fake parser was given with the GNU convention. */
+	inline void parse(argument_parser::v2::fake_parser &parser) {
+		parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	}
+
+	inline int run_all() {
+		for (auto const &test : registry()) {
+			int const before = failures;
+			try {
+				test.body();
+			} catch (std::exception const &e) {
+				std::cerr << test.name << ": unexpected exception: " << e.what() << "\n";
+				++failures;
+			}
+			std::cout << (failures == before ? "[pass] " : "[FAIL] ") << test.name << "\n";
+		}
+		return failures == 0 ? 0 : 1;
+	}
+} // namespace test_support
+
+#define TEST_CASE(name)                                                                                                \
+	static void name();                                                                                                \
+	static test_support::registrar const name##_registrar(#name, name);                                               \
+	static void name()
+
+#define CHECK(...) ((__VA_ARGS__) ? void() : test_support::fail(__FILE__, __LINE__, #__VA_ARGS__))
+
+#define CHECK_THROWS_AS(expression, type)                                                                              \
+	do {                                                                                                               \
+		bool thrown = false;                                                                                           \
+		try {                                                                                                          \
+			(void)(expression);                                                                                        \
+		} catch (type const &) {                                                                                       \
+			thrown = true;                                                                                             \
+		}                                                                                                              \
+		if (!thrown) {                                                                                                 \
+			test_support::fail(__FILE__, __LINE__, #expression " throws " #type);                                      \
+		}                                                                                                              \
+	} while (false)
+
+#endif // ARGUMENT_PARSER_TEST_SUPPORT_HPP
@@ -0,0 +1,98 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+#include <instrumentation.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+using argument_parser::instrumentation::trace_event;
+using argument_parser::instrumentation::trace_recorder;
+
+namespace {
+	bool has_event(std::vector<trace_event> const &events, const char *category, std::string const &name) {
+		return std::any_of(events.begin(), events.end(), [&](trace_event const &event) {
+			return std::strcmp(event.category, category) == 0 && event.name == name;
+		});
+	}
+
+	trace_event const *find_event(std::vector<trace_event> const &events, const char *category,
+								  std::string const &name) {
+		auto it = std::find_if(events.begin(), events.end(), [&](trace_event const &event) {
+			return std::strcmp(event.category, category) == 0 && event.name == name;
+		});
+		return it == events.end() ? nullptr : &*it;
+	}
+
+	bool encloses(trace_event const &outer, trace_event const &inner) {
+		return outer.thread == inner.thread && outer.start_ns <= inner.start_ns &&
+			   inner.start_ns + inner.duration_ns <= outer.start_ns + outer.duration_ns;
+	}
+} // namespace
+
+TEST_CASE(phases_actions_and_handlers_are_recorded) {
+	trace_recorder recorder;
+	argument_parser::v2::fake_parser parser("tool", {"--count", "5", "-v"});
+	parser.set_trace_recorder(&recorder);
+	int count = 0;
+	argument::start().long_argument("count").action<int>([&count](int const &value) { count = value; }).build(parser);
+	argument::start().short_argument("v").flag().build(parser);
+	parser.on_complete([](auto const &) {});
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(count == 5);
+
+	auto const events = recorder.events();
+	CHECK(has_event(events, "phase", "registration"));
+	CHECK(has_event(events, "phase", "extract_arguments"));
+	CHECK(has_event(events, "phase", "invoke_arguments"));
+	CHECK(has_event(events, "action", "count"));
+	CHECK(has_event(events, "on_complete", "on_complete"));
+
+	auto const *phase = find_event(events, "phase", "invoke_arguments");
+	auto const *action = find_event(events, "action", "count");
+	auto const *conversion = find_event(events, "parse", "count");
+	CHECK(phase != nullptr && action != nullptr && conversion != nullptr);
+	if (phase != nullptr && action != nullptr && conversion != nullptr) {
+		CHECK(encloses(*phase, *action));
+		CHECK(encloses(*action, *conversion));
+	}
+	CHECK(!has_event(events, "parse", "v"));
+
+	auto const trace = recorder.to_chrome_trace();
+	CHECK(trace.rfind("{\"traceEvents\":[", 0) == 0);
+	CHECK(trace.find("\"name\":\"count\"") != std::string::npos);
+	CHECK(recorder.summary().find("action count: 1 calls") != std::string::npos);
+
+	recorder.clear();
+	CHECK(recorder.events().empty());
+}
+
+TEST_CASE(events_can_be_read_while_other_threads_record) {
+	trace_recorder recorder;
+	std::thread writer([&recorder] {
+		for (int i = 0; i < 2000; ++i) {
+			auto const now = trace_recorder::clock::now();
+			recorder.record("span", "test", now, now);
+		}
+	});
+	std::size_t seen = 0;
+	while (seen < 2000) {
+		auto const events = recorder.events();
+		CHECK(events.size() >= seen);
+		seen = events.size();
+	}
+	writer.join();
+	CHECK(recorder.events().size() == 2000);
+}
+
+TEST_CASE(json_names_are_escaped) {
+	trace_recorder recorder;
+	auto const now = trace_recorder::clock::now();
+	recorder.record("a \"quoted\"\tname", "test", now, now);
+	CHECK(recorder.to_chrome_trace().find("a \\\"quoted\\\"\\tname") != std::string::npos);
+}
@@ -0,0 +1,84 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace flags = argument_parser::v2::flags;
+using argument_parser::v2::add_argument_flags;
+
+namespace {
+	std::string help_of(argument_parser::v2::fake_parser &parser) {
+		return parser.to_v1().build_help_text({&argument_parser::conventions::gnu_argument_convention});
+	}
+} // namespace
+
+TEST_CASE(initializer_list_registrations_parse) {
+	int jobs = 0;
+	bool ran = false;
+	argument_parser::v2::fake_parser parser("tool", {"-j", "4", "--run", "--name", "x", "-t", "a", "-t", "b", "in"});
+	parser.add_argument<int>({{flags::ShortArgument, "j"}, {flags::LongArgument, "jobs"}, {flags::Reference, &jobs}});
+	parser.add_argument({{flags::LongArgument, "run"},
+						 {flags::Action, argument_parser::helpers::make_non_parametered_action([&] { ran = true; })}});
+	parser.add_argument<std::string>({{flags::LongArgument, "name"}});
+	parser.add_argument<std::string>({{flags::ShortArgument, "t"}, {flags::Append, true}});
+	parser.add_argument<std::string>({{flags::Positional, "input"}, {flags::Required, true}});
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(jobs == 4);
+	CHECK(ran);
+	CHECK(parser.get_optional<std::string>("name") == std::string("x"));
+	CHECK(parser.get_optional<std::vector<std::string>>("t") == std::vector<std::string>{"a", "b"});
+	CHECK(parser.get_optional<std::string>("input") == std::string("in"));
+}
+
+TEST_CASE(map_registrations_parse) {
+	bool ran = false;
+	argument_parser::v2::fake_parser parser("tool", {"-vvv", "--level", "2", "--run"});
+	using v2_parser = argument_parser::v2::base_parser;
+	parser.add_argument(std::unordered_map<add_argument_flags, v2_parser::non_typed_flag_value>{
+		{flags::ShortArgument, "v"}, {flags::Count, true}});
+	// the map takes the move-only action over from the pair list
+	parser.add_argument(std::unordered_map<add_argument_flags, v2_parser::non_typed_flag_value>{
+		{flags::LongArgument, "run"},
+		{flags::Action, argument_parser::helpers::make_non_parametered_action([&ran] { ran = true; })}});
+	parser.add_argument<int>(std::unordered_map<add_argument_flags, v2_parser::typed_flag_value<int>>{
+		{flags::LongArgument, "level"}, {flags::HelpText, "How deep."}});
+	parser.handle_arguments({&argument_parser::conventions::gnu_argument_convention});
+	CHECK(parser.get_optional<int>("v") == 3);
+	CHECK(parser.get_optional<int>("level") == 2);
+	CHECK(ran);
+}
+
+TEST_CASE(invalid_flag_combinations_are_rejected) {
+	int target = 0;
+	argument_parser::v2::fake_parser parser("tool", {});
+	CHECK_THROWS_AS(parser.add_argument<int>(
+						{{flags::LongArgument, "a"},
+						 {flags::Action, argument_parser::helpers::make_parametered_action<int>([](int const &) {})},
+						 {flags::Reference, &target}}),
+					std::logic_error);
+	CHECK_THROWS_AS(parser.add_argument({{flags::LongArgument, "b"}, {flags::Append, true}, {flags::Count, true}}),
+					std::logic_error);
+	CHECK_THROWS_AS(parser.add_argument<int>({{flags::LongArgument, "c"}, {flags::Count, true}}), std::logic_error);
+	CHECK_THROWS_AS(parser.add_argument({{flags::LongArgument, "d"}, {flags::Append, true}}), std::logic_error);
+	CHECK_THROWS_AS(parser.add_argument<int>({{flags::Positional, "e"}, {flags::Append, true}}), std::logic_error);
+	CHECK_THROWS_AS(parser.add_argument({{flags::HelpText, "no names"}}), std::runtime_error);
+	CHECK_THROWS_AS(parser.add_argument({{flags::LongArgument, true}}), std::invalid_argument);
+}
+
+TEST_CASE(default_help_is_generated_from_the_trait) {
+	argument_parser::v2::fake_parser parser("tool", {});
+	parser.add_argument<int>({{flags::LongArgument, "jobs"}});
+	parser.add_argument<int>({{flags::LongArgument, "port"}, {flags::Append, true}});
+	parser.add_argument({{flags::LongArgument, "verbose"}, {flags::Count, true}});
+	parser.add_argument<int>({{flags::LongArgument, "own"}, {flags::HelpText, "Explained."}});
+	auto const help = help_of(parser);
+	CHECK(help.find("Accepts integer value in 123 format.") != std::string::npos);
+	CHECK(help.find("Accepts integer value in 123 format. May be repeated.") != std::string::npos);
+	CHECK(help.find("Counts occurrences.") != std::string::npos);
+	CHECK(help.find("Explained.") != std::string::npos);
+}
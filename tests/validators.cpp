@@ -0,0 +1,100 @@
+#include "test_support.hpp"
+
+#include <argparse>
+#include <fake_parser.hpp>
+#include <validators.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+using test_support::parse;
+namespace validators = argument_parser::validators;
+
+namespace {
+	std::string parse_error(argument_parser::v2::fake_parser &parser) {
+		try {
+			parse(parser);
+		} catch (std::runtime_error const &e) {
+			return e.what();
+		}
+		return {};
+	}
+} // namespace
+
+TEST_CASE(accepted_values_are_stored) {
+	argument_parser::v2::fake_parser parser("tool", {"--port", "80", "--mode", "fast", "--name", "abc-12"});
+	argument::start().long_argument("port").store<int>().validate({validators::range(1, 65535)}).build(parser);
+	argument::start()
+		.long_argument("mode")
+		.store<std::string>()
+		.validate({validators::one_of({"fast", "slow"})})
+		.build(parser);
+	argument::start()
+		.long_argument("name")
+		.store<std::string>()
+		.validate({validators::matches("[a-z]+-[0-9]+"),
+				   validators::predicate<std::string>([](auto const &s) { return s.size() < 10; }, "too long")})
+		.build(parser);
+	parse(parser);
+	CHECK(parser.get_optional<int>("port") == 80);
+	CHECK(parser.get_optional<std::string>("mode") == std::string("fast"));
+	CHECK(parser.get_optional<std::string>("name") == std::string("abc-12"));
+}
+
+TEST_CASE(a_rejected_value_fails_loud_and_is_not_stored) {
+	argument_parser::v2::fake_parser parser("tool", {"--port", "70000"});
+	argument::start().long_argument("port").store<int>().validate({validators::range(1, 65535)}).build(parser);
+	auto const error = parse_error(parser);
+	CHECK(error.find("'70000' is not accepted for port") != std::string::npos);
+	CHECK(!parser.get_optional<int>("port").has_value());
+}
+
+TEST_CASE(fail_skip_drops_only_the_rejected_values) {
+	argument_parser::v2::fake_parser parser("tool", {"-I", "a", "-I", "bad!", "-I", "c", "--level", "9"});
+	int level = -1;
+	argument::start()
+		.short_argument("I")
+		.append<std::string>()
+		.validate({{validators::matches("[a-z]+")}, validators::failure_policy::fail_skip})
+		.build(parser);
+	argument::start()
+		.long_argument("level")
+		.action<int>([&level](int value) { level = value; })
+		.validate({{validators::range(0, 5)}, validators::failure_policy::fail_skip})
+		.build(parser);
+	parse(parser);
+	CHECK((parser.get_optional<std::vector<std::string>>("I") == std::vector<std::string>{"a", "c"}));
+	CHECK(level == -1);
+}
+
+TEST_CASE(a_skipped_value_leaves_a_required_option_missing) {
+	argument_parser::v2::fake_parser parser("tool", {"--level", "9"});
+	argument::start()
+		.long_argument("level")
+		.store<int>()
+		.required()
+		.validate({{validators::range(0, 5)}, validators::failure_policy::fail_skip})
+		.build(parser);
+	parser.exit_on_requirement_errors(false);
+	CHECK_THROWS_AS(parse(parser), argument_parser::requirement_error);
+	CHECK(!parser.get_optional<int>("level").has_value());
+
+	parser.set_parsed_arguments({"--level", "3"});
+	parse(parser);
+	CHECK(parser.get_optional<int>("level") == 3);
+}
+
+TEST_CASE(appended_values_are_checked_as_a_batch) {
+	argument_parser::v2::fake_parser parser("tool", {"-I", "1", "-I", "9"});
+	argument::start().short_argument("I").append<int>().validate({validators::range(0, 5)}).build(parser);
+	CHECK(parse_error(parser).find("value #2 for I") != std::string::npos);
+}
+
+TEST_CASE(misconfigured_validators_are_logic_errors) {
+	CHECK_THROWS_AS(validators::matches("(("), std::logic_error);
+	argument_parser::v2::fake_parser parser("tool", {});
+	argument::start().long_argument("x").store<int>().build(parser);
+	CHECK_THROWS_AS(parser.set_validator<std::string>("x", {validators::matches("a")}), std::logic_error);
+}
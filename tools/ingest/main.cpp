@@ -0,0 +1,135 @@
+#include <argparse>
+#include <fstream>
+#include <iostream>
+#include <log_ingest.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+using argument = argument_parser::builder::argument<>;
+namespace ingest = argument_parser::ingest;
+namespace validators = argument_parser::validators;
+
+// Declares the options to parse from the command line of this tool. To ingest against the real schema of a program,
+// call ingest::ingest_file with a schema that runs that program's own registrations instead.
+auto make_schema(argument_parser::v2::parser &cli) -> ingest::schema {
+	auto names = [&cli](std::string const &option) {
+		return cli.get_optional<std::vector<std::string>>(option).value_or(std::vector<std::string>{});
+	};
+	auto integers = names("int");
+	auto reals = names("real");
+	auto texts = names("text");
+	auto flags = names("flag");
+
+	ingest::schema schema([=](argument_parser::v2::base_parser &parser) {
+		for (auto const &name : integers)
+			argument::start().long_argument(name).store<int>().build(parser);
+		for (auto const &name : reals)
+			argument::start().long_argument(name).store<double>().build(parser);
+		for (auto const &name : texts)
+			argument::start().long_argument(name).store<std::string>().build(parser);
+		for (auto const &name : flags)
+			argument::start().long_argument(name).flag().build(parser);
+	});
+	for (auto const &name : integers)
+		schema.column<int>(name);
+	for (auto const &name : reals)
+		schema.column<double>(name);
+	for (auto const &name : texts)
+		schema.column<std::string>(name);
+	for (auto const &name : flags)
+		schema.column<bool>(name);
+	return schema;
+}
+
+auto main() -> int {
+	argument_parser::v2::parser cli;
+
+	argument::start().positional("log").help_text("Log of recorded command lines.").required().store().build(cli);
+	argument::start()
+		.short_argument("o")
+		.long_argument("output")
+		.help_text("Output file (default: stdout).")
+		.store()
+		.build(cli);
+	argument::start()
+		.long_argument("format")
+		.help_text("csv or binary.")
+		.store()
+		.validate({validators::one_of({"csv", "binary"})})
+		.default_value(std::string("csv"))
+		.build(cli);
+	argument::start()
+		.long_argument("records")
+		.help_text("Record delimiter: newline or nul.")
+		.store()
+		.validate({validators::one_of({"newline", "nul"})})
+		.default_value(std::string("newline"))
+		.build(cli);
+	argument::start()
+		.long_argument("style")
+		.help_text("Option style of the log: gnu or windows.")
+		.store()
+		.validate({validators::one_of({"gnu", "windows"})})
+		.default_value(std::string("gnu"))
+		.build(cli);
+	argument::start()
+		.short_argument("j")
+		.long_argument("threads")
+		.help_text("Worker threads (0: all cores).")
+		.store<int>()
+		.default_value(0)
+		.build(cli);
+	for (auto const &[name, kind] : {std::pair{"int", "Integer"}, std::pair{"real", "Floating point"},
+									 std::pair{"text", "String"}, std::pair{"flag", "Boolean flag"}}) {
+		argument::start()
+			.long_argument(name)
+			.help_text(std::string(kind) + " option to parse, also written as a column. May be repeated.")
+			.append()
+			.build(cli);
+	}
+
+	try {
+		cli.handle_arguments({&argument_parser::conventions::gnu_argument_convention,
+							  &argument_parser::conventions::gnu_equal_argument_convention});
+
+		ingest::settings config;
+		if (cli.get_optional<std::string>("format").value() == "binary") {
+			config.output = ingest::output_format::binary;
+		}
+		if (cli.get_optional<std::string>("records").value() == "nul") {
+			config.records = ingest::record_format::nul_delimited;
+		}
+		config.max_threads = static_cast<unsigned>(std::max(0, cli.get_optional<int>("threads").value()));
+
+		auto schema = make_schema(cli);
+		auto log = cli.get_optional<std::string>("log").value();
+		auto output_path = cli.get_optional<std::string>("output");
+		std::ofstream file;
+		if (output_path.has_value()) {
+			file.open(output_path.value(), std::ios::binary);
+			if (!file) {
+				throw std::runtime_error("Cannot open output file: " + output_path.value());
+			}
+		}
+		std::ostream &output = output_path.has_value() ? file : std::cout;
+
+		ingest::summary totals;
+		if (cli.get_optional<std::string>("style").value() == "windows") {
+			totals = ingest::ingest_file(log, output, schema,
+										 {&argument_parser::conventions::windows_argument_convention,
+										  &argument_parser::conventions::windows_equal_argument_convention},
+										 config);
+		} else {
+			totals = ingest::ingest_file(log, output, schema,
+										 {&argument_parser::conventions::gnu_argument_convention,
+										  &argument_parser::conventions::gnu_equal_argument_convention},
+										 config);
+		}
+		std::cerr << totals.records << " records, " << totals.errors << " with errors\n";
+		return totals.errors == 0 ? 0 : 2;
+	} catch (std::exception const &e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}